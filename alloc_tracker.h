@@ -0,0 +1,40 @@
+﻿#pragma once
+// ========== 堆分配计数 ==========
+// 定义 PONG_ALLOC_TRACKING 后替换全局 operator new/delete，按线程统计分配次数，
+// 用来检查稳态帧循环是否还在分配内存。音频、录制、遥测等后台线程各自计数，不影响游戏线程。
+// 替换函数不能是inline，所以定义了宏时这个头文件只能被一个翻译单元包含。
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace alloc_tracker {
+
+inline thread_local std::uint64_t threadAllocations = 0;
+
+// 当前线程至今的 operator new 调用次数（未定义 PONG_ALLOC_TRACKING 时恒为0）
+inline std::uint64_t allocationCount() { return threadAllocations; }
+
+#ifdef PONG_ALLOC_TRACKING
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+} // namespace alloc_tracker
+
+#ifdef PONG_ALLOC_TRACKING
+// nothrow 和数组版本的默认实现都会转到这里；对齐版本不计数
+void* operator new(std::size_t size) {
+    ++alloc_tracker::threadAllocations;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+#endif
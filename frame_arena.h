@@ -0,0 +1,87 @@
+﻿#pragma once
+// ========== 每帧线性分配器 ==========
+// 启动时分配一整块内存，帧内的临时数据（粒子顶点、格式化文本）按指针递增分配，
+// 每帧开始时整体复位。帧循环里不再走堆分配，避免分配器抖动造成的卡顿。
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t capacity) : buffer(new std::byte[capacity]), capacity(capacity) {}
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 空间不足时返回nullptr，调用方自行分批或放弃（不会退回到堆分配）
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        std::size_t start = alignUp(used, alignment);
+        if (start > capacity || bytes > capacity - start) {
+            return nullptr;
+        }
+        used = start + bytes;
+        if (used > highWater) {
+            highWater = used;
+        }
+        return buffer.get() + start;
+    }
+
+    // 只用于平凡类型：复位时不调用析构函数
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "帧内存复位时不会调用析构函数");
+        void* memory = allocate(sizeof(T) * count, alignof(T));
+        if (!memory) {
+            return nullptr;
+        }
+        T* items = static_cast<T*>(memory);
+        for (std::size_t i = 0; i < count; ++i) {
+            new (items + i) T();
+        }
+        return items;
+    }
+
+    // 按alignment对齐后还能放下多少个T
+    template <typename T>
+    std::size_t remainingFor() const {
+        std::size_t start = alignUp(used, alignof(T));
+        return start >= capacity ? 0 : (capacity - start) / sizeof(T);
+    }
+
+    // printf风格格式化到帧内存，空间不足时返回空串
+    const char* format(const char* pattern, ...) {
+        char* text = static_cast<char*>(allocate(FORMAT_MAX, 1));
+        if (!text) {
+            return "";
+        }
+        std::va_list args;
+        va_start(args, pattern);
+        int length = std::vsnprintf(text, FORMAT_MAX, pattern, args);
+        va_end(args);
+        // 退还没用到的部分
+        if (length >= 0 && static_cast<std::size_t>(length) + 1 < FORMAT_MAX) {
+            used -= FORMAT_MAX - (length + 1);
+        }
+        return text;
+    }
+
+    void reset() { used = 0; }
+
+    std::size_t bytesUsed() const { return used; }
+    std::size_t peakBytes() const { return highWater; }
+
+private:
+    static constexpr std::size_t FORMAT_MAX = 256;
+
+    static std::size_t alignUp(std::size_t offset, std::size_t alignment) {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    std::unique_ptr<std::byte[]> buffer;
+    std::size_t capacity;
+    std::size_t used = 0;
+    std::size_t highWater = 0;
+};
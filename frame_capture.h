@@ -0,0 +1,167 @@
+﻿#pragma once
+// ========== 异步帧录制 ==========
+// 游戏线程把每帧RGBA像素复制进预先分配好的环形缓冲区，后台编码线程
+// 转成YUV420写Y4M（或直接写原始RGBA流）。缓冲区满时丢帧并计数，绝不阻塞游戏线程。
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FrameCapture {
+public:
+    FrameCapture() = default;
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    ~FrameCapture() { close(); }
+
+    // path以 .y4m 结尾写Y4M，否则写原始RGBA帧序列
+    bool open(const std::string& path, unsigned width, unsigned height, unsigned fps, std::size_t ringSize = 8) {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        frameWidth = width;
+        frameHeight = height;
+        y4m = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+
+        // 所有缓冲区一次分配好，录制过程中不再分配
+        slots.assign(ringSize, std::vector<std::uint8_t>(static_cast<std::size_t>(width) * height * 4));
+        if (y4m) {
+            std::fprintf(file, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", width, height, fps);
+            yuv.resize(static_cast<std::size_t>(width) * height + 2 * chromaSize());
+        }
+
+        head = 0;
+        tail = 0;
+        written = 0;
+        dropped = 0;
+        running = true;
+        worker = std::thread(&FrameCapture::encodeLoop, this);
+        return true;
+    }
+
+    // 游戏线程调用：复制一帧（宽x高x4字节RGBA），缓冲区满时丢帧返回false
+    bool submit(const std::uint8_t* rgba) {
+        std::uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= slots.size()) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        std::vector<std::uint8_t>& slot = slots[h % slots.size()];
+        std::memcpy(slot.data(), rgba, slot.size());
+        head.store(h + 1, std::memory_order_release);
+        wakeup.notify_one();
+        return true;
+    }
+
+    // 写完缓冲区里剩余的帧并关闭文件
+    void close() {
+        if (worker.joinable()) {
+            running = false;
+            wakeup.notify_one();
+            worker.join();
+        }
+        if (file) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+
+    bool isOpen() const { return file != nullptr; }
+    std::uint64_t framesSubmitted() const { return head.load(std::memory_order_relaxed); }
+    std::uint64_t framesWritten() const { return written.load(std::memory_order_relaxed); }
+    std::uint64_t framesDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::size_t chromaSize() const {
+        return static_cast<std::size_t>((frameWidth + 1) / 2) * ((frameHeight + 1) / 2);
+    }
+
+    void encodeLoop() {
+        for (;;) {
+            std::uint64_t t = tail.load(std::memory_order_relaxed);
+            if (t == head.load(std::memory_order_acquire)) {
+                if (!running) {
+                    break;
+                }
+                // 带超时等待，避免通知在检查和等待之间丢失
+                std::unique_lock<std::mutex> lock(wakeupMutex);
+                wakeup.wait_for(lock, std::chrono::milliseconds(5));
+                continue;
+            }
+
+            const std::vector<std::uint8_t>& slot = slots[t % slots.size()];
+            if (y4m) {
+                convertToI420(slot.data());
+                std::fputs("FRAME\n", file);
+                std::fwrite(yuv.data(), 1, yuv.size(), file);
+            }
+            else {
+                std::fwrite(slot.data(), 1, slot.size(), file);
+            }
+            tail.store(t + 1, std::memory_order_release);
+            written.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::fflush(file);
+    }
+
+    // BT.601全范围（C420jpeg），色度取2x2平均
+    void convertToI420(const std::uint8_t* rgba) {
+        const unsigned w = frameWidth;
+        const unsigned h = frameHeight;
+        const unsigned chromaWidth = (w + 1) / 2;
+        std::uint8_t* yPlane = yuv.data();
+        std::uint8_t* uPlane = yPlane + static_cast<std::size_t>(w) * h;
+        std::uint8_t* vPlane = uPlane + chromaSize();
+
+        for (unsigned y = 0; y < h; ++y) {
+            const std::uint8_t* row = rgba + static_cast<std::size_t>(y) * w * 4;
+            for (unsigned x = 0; x < w; ++x) {
+                int r = row[x * 4], g = row[x * 4 + 1], b = row[x * 4 + 2];
+                yPlane[static_cast<std::size_t>(y) * w + x] = static_cast<std::uint8_t>((77 * r + 150 * g + 29 * b) >> 8);
+            }
+        }
+        for (unsigned cy = 0; cy < (h + 1) / 2; ++cy) {
+            for (unsigned cx = 0; cx < chromaWidth; ++cx) {
+                int r = 0, g = 0, b = 0, n = 0;
+                for (unsigned dy = 0; dy < 2; ++dy) {
+                    for (unsigned dx = 0; dx < 2; ++dx) {
+                        unsigned px = cx * 2 + dx, py = cy * 2 + dy;
+                        if (px < w && py < h) {
+                            const std::uint8_t* p = rgba + (static_cast<std::size_t>(py) * w + px) * 4;
+                            r += p[0]; g += p[1]; b += p[2]; ++n;
+                        }
+                    }
+                }
+                r /= n; g /= n; b /= n;
+                std::size_t i = static_cast<std::size_t>(cy) * chromaWidth + cx;
+                uPlane[i] = static_cast<std::uint8_t>(((-43 * r - 85 * g + 128 * b) >> 8) + 128);
+                vPlane[i] = static_cast<std::uint8_t>(((128 * r - 107 * g - 21 * b) >> 8) + 128);
+            }
+        }
+    }
+
+    std::FILE* file = nullptr;
+    unsigned frameWidth = 0;
+    unsigned frameHeight = 0;
+    bool y4m = false;
+
+    std::vector<std::vector<std::uint8_t>> slots;  // 环形缓冲区（单生产者单消费者）
+    std::vector<std::uint8_t> yuv;                 // 编码线程专用
+    std::atomic<std::uint64_t> head{ 0 };          // 游戏线程写入位置
+    std::atomic<std::uint64_t> tail{ 0 };          // 编码线程读取位置
+    std::atomic<std::uint64_t> written{ 0 };
+    std::atomic<std::uint64_t> dropped{ 0 };
+    std::atomic<bool> running{ false };
+
+    std::thread worker;
+    std::mutex wakeupMutex;
+    std::condition_variable wakeup;
+};
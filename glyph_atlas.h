@@ -0,0 +1,302 @@
+﻿#pragma once
+// ========== 预烘焙字形图集 ==========
+// tools/bake_glyph_atlas（或不依赖SFML的 bake_glyph_atlas_freetype）离线把字体光栅化成图集和度量表；
+// 运行时 AtlasText 按度量表排版，
+// TextBatch 把一帧内所有文本拼成一批三角形，用图集纹理一次画完。
+// 启动时不再加载TTF，也不会在第一次显示某段文字时临时光栅化字形。
+// 图集缺失时 AtlasText 退回到 sf::Text + TTF。
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct AtlasGlyph {
+    float advance = 0.f;
+    sf::FloatRect bounds;     // 相对基线的字形矩形（与 sf::Glyph::bounds 相同）
+    sf::IntRect textureRect;  // 图集中的像素矩形
+};
+
+class GlyphAtlas {
+public:
+    static constexpr int FORMAT_VERSION = 1;
+    static constexpr unsigned BAKED_SIZES[] = { 24, 30, 36, 48, 60 };  // 游戏里用到的全部字号
+    static constexpr char32_t FIRST_CHAR = U' ';
+    static constexpr char32_t LAST_CHAR = U'~';
+
+    // metricsPath: 烘焙工具输出的 .atlas 度量表，图集PNG与它在同一目录
+    bool loadFromFile(const std::string& metricsPath) {
+        tables.clear();
+        loaded = false;
+        std::ifstream in(metricsPath);
+        std::string tag;
+        int version = 0;
+        if (!(in >> tag >> version) || tag != "pong-glyph-atlas" || version != FORMAT_VERSION) {
+            return false;
+        }
+
+        std::string imageName;
+        while (in >> tag) {
+            if (tag == "image") {
+                in >> imageName;
+            }
+            else if (tag == "size") {
+                SizeTable table;
+                in >> table.size >> table.lineSpacing;
+                tables.push_back(table);
+            }
+            else if (tag == "glyph") {
+                unsigned size = 0, code = 0;
+                AtlasGlyph glyph;
+                in >> size >> code >> glyph.advance >> glyph.bounds.position.x >> glyph.bounds.position.y >>
+                    glyph.bounds.size.x >> glyph.bounds.size.y >> glyph.textureRect.position.x >>
+                    glyph.textureRect.position.y >> glyph.textureRect.size.x >> glyph.textureRect.size.y;
+                SizeTable* table = findTable(size);
+                if (!in || !table || code < FIRST_CHAR || code > LAST_CHAR) {
+                    return false;
+                }
+                table->glyphs[code - FIRST_CHAR] = glyph;
+                table->present[code - FIRST_CHAR] = true;
+            }
+            else if (tag == "kern") {
+                unsigned size = 0, first = 0, second = 0;
+                float offset = 0.f;
+                in >> size >> first >> second >> offset;
+                SizeTable* table = findTable(size);
+                if (!in || !table) {
+                    return false;
+                }
+                table->kerning.push_back({ kerningKey(first, second), offset });
+            }
+            else {
+                return false;
+            }
+        }
+
+        for (SizeTable& table : tables) {
+            std::sort(table.kerning.begin(), table.kerning.end(),
+                [](const KerningPair& a, const KerningPair& b) { return a.key < b.key; });
+        }
+
+        std::string directory = metricsPath.substr(0, metricsPath.find_last_of("/\\") + 1);
+        if (imageName.empty() || !atlasTexture.loadFromFile(directory + imageName)) {
+            return false;
+        }
+        atlasTexture.setSmooth(true);  // 与SFML字体纹理的默认采样一致
+        loaded = true;
+        return true;
+    }
+
+    bool isLoaded() const { return loaded; }
+    bool hasSize(unsigned size) const { return findTable(size) != nullptr; }
+    const sf::Texture& texture() const { return atlasTexture; }
+
+    const AtlasGlyph* findGlyph(unsigned size, char32_t c) const {
+        const SizeTable* table = findTable(size);
+        if (!table || c < FIRST_CHAR || c > LAST_CHAR || !table->present[c - FIRST_CHAR]) {
+            return nullptr;
+        }
+        return &table->glyphs[c - FIRST_CHAR];
+    }
+
+    float lineSpacing(unsigned size) const {
+        const SizeTable* table = findTable(size);
+        return table ? table->lineSpacing : 0.f;
+    }
+
+    float kerning(unsigned size, char32_t first, char32_t second) const {
+        const SizeTable* table = findTable(size);
+        if (!table || first == 0) {
+            return 0.f;
+        }
+        std::uint32_t key = kerningKey(first, second);
+        auto it = std::lower_bound(table->kerning.begin(), table->kerning.end(), key,
+            [](const KerningPair& pair, std::uint32_t value) { return pair.key < value; });
+        return (it != table->kerning.end() && it->key == key) ? it->offset : 0.f;
+    }
+
+private:
+    static constexpr std::size_t CHAR_COUNT = LAST_CHAR - FIRST_CHAR + 1;
+
+    struct KerningPair {
+        std::uint32_t key;
+        float offset;
+    };
+
+    struct SizeTable {
+        unsigned size = 0;
+        float lineSpacing = 0.f;
+        std::array<AtlasGlyph, CHAR_COUNT> glyphs{};
+        std::array<bool, CHAR_COUNT> present{};
+        std::vector<KerningPair> kerning;  // 按key排序
+    };
+
+    static std::uint32_t kerningKey(char32_t first, char32_t second) {
+        return (static_cast<std::uint32_t>(first) << 16) | static_cast<std::uint32_t>(second);
+    }
+
+    SizeTable* findTable(unsigned size) {
+        for (SizeTable& table : tables) {
+            if (table.size == size) return &table;
+        }
+        return nullptr;
+    }
+    const SizeTable* findTable(unsigned size) const {
+        return const_cast<GlyphAtlas*>(this)->findTable(size);
+    }
+
+    std::vector<SizeTable> tables;
+    sf::Texture atlasTexture;
+    bool loaded = false;
+};
+
+// ========== 图集文本 ==========
+// 接口对应游戏里用到的 sf::Text 子集；排版规则与 sf::Text 相同（基线在 y = 字号，
+// 字形四边各外扩1像素采样），只在setString时重排，颜色和位置在合批时才应用
+class AtlasText {
+public:
+    // atlas未加载或缺少该字号时使用fallbackFont（两者都没有时不显示）
+    AtlasText(const GlyphAtlas& atlas, const sf::Font* fallbackFont, const char* text, unsigned characterSize)
+        : atlas(atlas), characterSize(characterSize) {
+        if (!(atlas.isLoaded() && atlas.hasSize(characterSize)) && fallbackFont) {
+            fallback.emplace(*fallbackFont, text, characterSize);
+        }
+        content.reserve(64);
+        localVertices.reserve(64 * 6);
+        setString(text);
+    }
+
+    void setString(const char* text) {
+        if (fallback) {
+            fallback->setString(text);
+            return;
+        }
+        if (content == text) {
+            return;
+        }
+        content = text;
+        layout();
+    }
+
+    void setFillColor(sf::Color color) {
+        fillColor = color;
+        if (fallback) fallback->setFillColor(color);
+    }
+    void setOrigin(sf::Vector2f value) {
+        origin = value;
+        if (fallback) fallback->setOrigin(value);
+    }
+    void setPosition(sf::Vector2f value) {
+        position = value;
+        if (fallback) fallback->setPosition(value);
+    }
+
+    sf::FloatRect getLocalBounds() const { return fallback ? fallback->getLocalBounds() : bounds; }
+    unsigned getCharacterSize() const { return characterSize; }
+
+private:
+    friend class TextBatch;
+
+    void layout() {
+        localVertices.clear();
+        float x = 0.f;
+        const float y = static_cast<float>(characterSize);
+        float minX = y, minY = y, maxX = 0.f, maxY = 0.f;
+        char32_t previous = 0;
+        for (unsigned char byte : content) {
+            char32_t c = byte;
+            x += atlas.kerning(characterSize, previous, c);
+            previous = c;
+            const AtlasGlyph* glyph = atlas.findGlyph(characterSize, c);
+            if (c == U' ') {
+                minX = std::min(minX, x);
+                minY = std::min(minY, y);
+                x += glyph ? glyph->advance : 0.f;
+                maxX = std::max(maxX, x);
+                maxY = std::max(maxY, y);
+                continue;
+            }
+            if (!glyph) {
+                continue;
+            }
+
+            const float padding = 1.f;
+            float left = glyph->bounds.position.x - padding;
+            float top = glyph->bounds.position.y - padding;
+            float right = glyph->bounds.position.x + glyph->bounds.size.x + padding;
+            float bottom = glyph->bounds.position.y + glyph->bounds.size.y + padding;
+            float u1 = static_cast<float>(glyph->textureRect.position.x) - padding;
+            float v1 = static_cast<float>(glyph->textureRect.position.y) - padding;
+            float u2 = static_cast<float>(glyph->textureRect.position.x + glyph->textureRect.size.x) + padding;
+            float v2 = static_cast<float>(glyph->textureRect.position.y + glyph->textureRect.size.y) + padding;
+            localVertices.push_back({ { x + left, y + top }, sf::Color::White, { u1, v1 } });
+            localVertices.push_back({ { x + right, y + top }, sf::Color::White, { u2, v1 } });
+            localVertices.push_back({ { x + left, y + bottom }, sf::Color::White, { u1, v2 } });
+            localVertices.push_back({ { x + left, y + bottom }, sf::Color::White, { u1, v2 } });
+            localVertices.push_back({ { x + right, y + top }, sf::Color::White, { u2, v1 } });
+            localVertices.push_back({ { x + right, y + bottom }, sf::Color::White, { u2, v2 } });
+
+            minX = std::min(minX, x + glyph->bounds.position.x);
+            maxX = std::max(maxX, x + glyph->bounds.position.x + glyph->bounds.size.x);
+            minY = std::min(minY, y + glyph->bounds.position.y);
+            maxY = std::max(maxY, y + glyph->bounds.position.y + glyph->bounds.size.y);
+            x += glyph->advance;
+        }
+        bounds = content.empty() ? sf::FloatRect() : sf::FloatRect({ minX, minY }, { maxX - minX, maxY - minY });
+    }
+
+    const GlyphAtlas& atlas;
+    unsigned characterSize;
+    std::string content;
+    std::vector<sf::Vertex> localVertices;  // 相对文本原点，未着色
+    sf::FloatRect bounds;
+    sf::Color fillColor = sf::Color::White;
+    sf::Vector2f origin;
+    sf::Vector2f position;
+    std::optional<sf::Text> fallback;
+};
+
+// ========== 文本合批 ==========
+// 每帧add要画的文本，draw时用图集纹理一次提交；退回TTF的文本逐个绘制
+class TextBatch {
+public:
+    explicit TextBatch(const GlyphAtlas& atlas, std::size_t vertexCapacity = 4096) : atlas(atlas) {
+        vertices.reserve(vertexCapacity);
+        fallbackTexts.reserve(32);
+    }
+
+    void add(const AtlasText& text) {
+        if (text.fallback) {
+            fallbackTexts.push_back(&text);
+            return;
+        }
+        if (text.fillColor.a == 0) {
+            return;  // 闪烁时的透明文字不占顶点
+        }
+        sf::Vector2f offset = text.position - text.origin;
+        for (const sf::Vertex& vertex : text.localVertices) {
+            vertices.push_back({ vertex.position + offset, text.fillColor, vertex.texCoords });
+        }
+    }
+
+    void draw(sf::RenderTarget& target) {
+        if (!vertices.empty()) {
+            sf::RenderStates states;
+            states.texture = &atlas.texture();
+            target.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles, states);
+        }
+        for (const AtlasText* text : fallbackTexts) {
+            target.draw(*text->fallback);
+        }
+        vertices.clear();
+        fallbackTexts.clear();
+    }
+
+private:
+    const GlyphAtlas& atlas;
+    std::vector<sf::Vertex> vertices;
+    std::vector<const AtlasText*> fallbackTexts;
+};
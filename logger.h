@@ -0,0 +1,401 @@
+﻿#pragma once
+// ========== 异步日志 ==========
+// 游戏线程只把“静态格式串指针 + 类型化参数”写进无锁环形队列，不格式化、不分配、不等待；
+// 后台线程取出后再格式化并写控制台，也可以同时写二进制日志（tools/log_reader 解码）。
+// 队列满时丢弃并计数，保证游戏线程永远不会因为输出而阻塞。
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+enum class LogLevel : std::uint8_t {
+    Debug = 0,
+    Info = 1,
+    Warn = 2,
+    Error = 3
+};
+
+inline const char* logLevelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info: return "INFO";
+    case LogLevel::Warn: return "WARN";
+    case LogLevel::Error: return "ERROR";
+    }
+    return "?";
+}
+
+enum class LogArgType : std::uint8_t {
+    Int = 1,
+    UInt = 2,
+    Double = 3,
+    String = 4
+};
+
+// 格式化时用的参数值（字符串指向记录内的副本或读取缓冲区）
+struct LogValue {
+    LogArgType type = LogArgType::Int;
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        const char* s;
+    };
+    LogValue() : i(0) {}
+};
+
+// 按printf语法格式化：每个转换说明符取下一个参数，长度修饰符按参数的实际类型重写
+inline void formatLogMessage(const char* format, const LogValue* values, int valueCount, char* out, std::size_t outSize) {
+    std::size_t used = 0;
+    int next = 0;
+    auto append = [&](const char* text, std::size_t length) {
+        std::size_t room = outSize - 1 - used;
+        length = length < room ? length : room;
+        std::memcpy(out + used, text, length);
+        used += length;
+    };
+    for (const char* p = format; *p && used + 1 < outSize; ++p) {
+        if (*p != '%') {
+            append(p, 1);
+            continue;
+        }
+        if (p[1] == '%') {
+            append("%", 1);
+            ++p;
+            continue;
+        }
+        // 复制标志、宽度、精度，跳过原有的长度修饰符
+        char spec[32] = "%";
+        std::size_t specLength = 1;
+        const char* q = p + 1;
+        while (*q && std::strchr("-+ #0123456789.", *q) && specLength < 20) {
+            spec[specLength++] = *q++;
+        }
+        while (*q && std::strchr("hljztL", *q)) {
+            ++q;
+        }
+        char conversion = *q;
+        if (!conversion) {
+            break;
+        }
+        p = q;
+
+        char piece[256];
+        int written = 0;
+        if (next >= valueCount) {
+            written = std::snprintf(piece, sizeof(piece), "<缺少参数>");
+        }
+        else {
+            const LogValue& value = values[next++];
+            switch (value.type) {
+            case LogArgType::Int:
+            case LogArgType::UInt:
+                if (std::strchr("diouxXc", conversion)) {
+                    spec[specLength++] = 'l';
+                    spec[specLength++] = 'l';
+                    spec[specLength++] = conversion;
+                    written = value.type == LogArgType::Int ? std::snprintf(piece, sizeof(piece), spec, value.i)
+                                                            : std::snprintf(piece, sizeof(piece), spec, value.u);
+                }
+                else {
+                    spec[specLength++] = 'g';
+                    written = std::snprintf(piece, sizeof(piece), spec,
+                        value.type == LogArgType::Int ? static_cast<double>(value.i) : static_cast<double>(value.u));
+                }
+                break;
+            case LogArgType::Double:
+                spec[specLength++] = std::strchr("fFeEgGaA", conversion) ? conversion : 'g';
+                written = std::snprintf(piece, sizeof(piece), spec, value.d);
+                break;
+            case LogArgType::String:
+                spec[specLength++] = 's';
+                written = std::snprintf(piece, sizeof(piece), spec, value.s);
+                break;
+            }
+        }
+        if (written > 0) {
+            append(piece, static_cast<std::size_t>(written) < sizeof(piece) ? written : sizeof(piece) - 1);
+        }
+    }
+    out[used] = '\0';
+}
+
+class Logger {
+public:
+    static constexpr int MAX_ARGS = 6;
+    static constexpr std::size_t TEXT_BYTES = 96;          // 每条记录里字符串参数的副本
+    static constexpr std::size_t QUEUE_CAPACITY = 1024;    // 2的幂
+
+    Logger() : slots(new Slot[QUEUE_CAPACITY]), startTime(std::chrono::steady_clock::now()) {
+        for (std::size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        worker = std::thread(&Logger::drainLoop, this);
+    }
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // 写完队列里剩余的记录再退出
+    ~Logger() {
+        running = false;
+        worker.join();
+        if (binaryFile) {
+            std::fclose(binaryFile);
+        }
+        if (std::FILE* file = pendingBinaryFile.load()) {
+            std::fclose(file);
+        }
+    }
+
+    // 二进制日志：格式串第一次出现时写一次，之后每条记录只写编号和原始参数
+    bool openBinarySink(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        std::fwrite("PLOG", 1, 4, file);
+        std::fputc(BINARY_VERSION, file);
+        pendingBinaryFile.store(file, std::memory_order_release);
+        return true;
+    }
+
+    void setLevel(LogLevel level) { minimumLevel.store(level, std::memory_order_relaxed); }
+    void setConsoleEnabled(bool enabled) { consoleEnabled.store(enabled, std::memory_order_relaxed); }
+
+    template <std::size_t N, typename... Args>
+    void debug(const char (&format)[N], const Args&... args) { write(LogLevel::Debug, format, args...); }
+    template <std::size_t N, typename... Args>
+    void info(const char (&format)[N], const Args&... args) { write(LogLevel::Info, format, args...); }
+    template <std::size_t N, typename... Args>
+    void warn(const char (&format)[N], const Args&... args) { write(LogLevel::Warn, format, args...); }
+    template <std::size_t N, typename... Args>
+    void error(const char (&format)[N], const Args&... args) { write(LogLevel::Error, format, args...); }
+
+    std::uint64_t droppedRecords() const { return dropped.load(std::memory_order_relaxed); }
+
+    static constexpr std::uint8_t BINARY_VERSION = 1;
+
+private:
+    struct RecordArg {
+        LogArgType type;
+        std::uint8_t textOffset;
+        union {
+            long long i;
+            unsigned long long u;
+            double d;
+        };
+    };
+
+    struct Record {
+        std::uint64_t timestamp;  // 自日志创建起的纳秒
+        const char* format;       // 必须是静态字符串
+        LogLevel level;
+        std::uint8_t argCount;
+        std::uint8_t textUsed;
+        RecordArg args[MAX_ARGS];
+        char text[TEXT_BYTES];
+    };
+
+    // 有界多生产者单消费者队列：每个槽位带序号，生产者CAS抢占写入位置
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        Record record;
+    };
+
+    // 参数按类型写入记录：整数、浮点按值，字符串复制一份（超长截断）
+    template <typename T>
+    static void storeArg(Record& record, const T& value) {
+        RecordArg& arg = record.args[record.argCount++];
+        if constexpr (std::is_same_v<T, std::string>) {
+            storeText(record, arg, value.c_str());
+        }
+        else if constexpr (std::is_convertible_v<T, const char*>) {
+            storeText(record, arg, value);
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            arg.type = LogArgType::Double;
+            arg.d = static_cast<double>(value);
+        }
+        else if constexpr (std::is_enum_v<T>) {
+            arg.type = LogArgType::Int;
+            arg.i = static_cast<long long>(value);
+        }
+        else if constexpr (std::is_signed_v<T>) {
+            arg.type = LogArgType::Int;
+            arg.i = static_cast<long long>(value);
+        }
+        else {
+            static_assert(std::is_integral_v<T>, "日志参数只支持整数、浮点数和字符串");
+            arg.type = LogArgType::UInt;
+            arg.u = static_cast<unsigned long long>(value);
+        }
+    }
+
+    static void storeText(Record& record, RecordArg& arg, const char* text) {
+        arg.type = LogArgType::String;
+        arg.textOffset = record.textUsed;
+        std::size_t room = TEXT_BYTES - record.textUsed;
+        std::size_t length = text ? std::strlen(text) : 0;
+        if (room == 0) {
+            arg.textOffset = static_cast<std::uint8_t>(TEXT_BYTES - 1);  // 指向末尾的空串
+            return;
+        }
+        length = length < room - 1 ? length : room - 1;
+        std::memcpy(record.text + record.textUsed, text, length);
+        record.text[record.textUsed + length] = '\0';
+        record.textUsed = static_cast<std::uint8_t>(record.textUsed + length + 1);
+    }
+
+    template <typename... Args>
+    void write(LogLevel level, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "日志参数过多");
+        if (level < minimumLevel.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &slots[position & (QUEUE_CAPACITY - 1)];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (difference < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);  // 队列满：丢弃，不等待
+                return;
+            }
+            else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        Record& record = slot->record;
+        record.timestamp = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime).count());
+        record.format = format;
+        record.level = level;
+        record.argCount = 0;
+        record.textUsed = 0;
+        record.text[TEXT_BYTES - 1] = '\0';
+        (storeArg(record, args), ...);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    bool tryDequeue(Record& out) {
+        Slot& slot = slots[dequeuePosition & (QUEUE_CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+            return false;
+        }
+        out = slot.record;
+        slot.sequence.store(dequeuePosition + QUEUE_CAPACITY, std::memory_order_release);
+        ++dequeuePosition;
+        return true;
+    }
+
+    // ========== 后台线程 ==========
+    void drainLoop() {
+        Record record;
+        char message[1024];
+        for (;;) {
+            if (std::FILE* file = pendingBinaryFile.exchange(nullptr, std::memory_order_acquire)) {
+                binaryFile = file;
+            }
+            bool any = false;
+            while (tryDequeue(record)) {
+                any = true;
+                if (consoleEnabled.load(std::memory_order_relaxed)) {
+                    LogValue values[MAX_ARGS];
+                    toValues(record, values);
+                    formatLogMessage(record.format, values, record.argCount, message, sizeof(message));
+                    std::fprintf(stdout, "[%9.3f %-5s] %s\n", record.timestamp / 1e9, logLevelName(record.level), message);
+                }
+                if (binaryFile) {
+                    writeBinary(record);
+                }
+            }
+            if (any) {
+                std::fflush(stdout);
+                if (binaryFile) std::fflush(binaryFile);
+            }
+            else if (!running.load(std::memory_order_acquire)) {
+                break;  // 已排空
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    }
+
+    static void toValues(const Record& record, LogValue* values) {
+        for (int i = 0; i < record.argCount; ++i) {
+            const RecordArg& arg = record.args[i];
+            values[i].type = arg.type;
+            switch (arg.type) {
+            case LogArgType::Int: values[i].i = arg.i; break;
+            case LogArgType::UInt: values[i].u = arg.u; break;
+            case LogArgType::Double: values[i].d = arg.d; break;
+            case LogArgType::String: values[i].s = record.text + arg.textOffset; break;
+            }
+        }
+    }
+
+    // 标记1: 格式串定义 [u32 编号][u16 长度][字节]
+    // 标记2: 记录 [u32 格式串编号][u8 级别][u64 纳秒][u8 参数个数] + 每个参数 [u8 类型][8字节值 | u8 长度+字节]
+    void writeBinary(const Record& record) {
+        auto found = formatIds.find(record.format);
+        std::uint32_t id = 0;
+        if (found == formatIds.end()) {
+            id = static_cast<std::uint32_t>(formatIds.size());
+            formatIds.emplace(record.format, id);
+            std::uint16_t length = static_cast<std::uint16_t>(std::strlen(record.format));
+            std::fputc(1, binaryFile);
+            std::fwrite(&id, sizeof(id), 1, binaryFile);
+            std::fwrite(&length, sizeof(length), 1, binaryFile);
+            std::fwrite(record.format, 1, length, binaryFile);
+        }
+        else {
+            id = found->second;
+        }
+        std::fputc(2, binaryFile);
+        std::fwrite(&id, sizeof(id), 1, binaryFile);
+        std::fputc(static_cast<int>(record.level), binaryFile);
+        std::fwrite(&record.timestamp, sizeof(record.timestamp), 1, binaryFile);
+        std::fputc(record.argCount, binaryFile);
+        for (int i = 0; i < record.argCount; ++i) {
+            const RecordArg& arg = record.args[i];
+            std::fputc(static_cast<int>(arg.type), binaryFile);
+            if (arg.type == LogArgType::String) {
+                const char* text = record.text + arg.textOffset;
+                std::uint8_t length = static_cast<std::uint8_t>(std::strlen(text));
+                std::fputc(length, binaryFile);
+                std::fwrite(text, 1, length, binaryFile);
+            }
+            else {
+                std::fwrite(&arg.i, 8, 1, binaryFile);
+            }
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<std::size_t> enqueuePosition{ 0 };
+    std::size_t dequeuePosition = 0;  // 只有后台线程访问
+    std::atomic<std::uint64_t> dropped{ 0 };
+    std::atomic<LogLevel> minimumLevel{ LogLevel::Info };
+    std::atomic<bool> consoleEnabled{ true };
+    std::atomic<bool> running{ true };
+    std::chrono::steady_clock::time_point startTime;
+
+    std::atomic<std::FILE*> pendingBinaryFile{ nullptr };
+    std::FILE* binaryFile = nullptr;                                // 只有后台线程访问
+    std::unordered_map<const char*, std::uint32_t> formatIds;       // 只有后台线程访问
+    std::thread worker;
+};
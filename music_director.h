@@ -0,0 +1,99 @@
+﻿#pragma once
+// ========== 背景音乐 ==========
+// 用 sf::Music 从磁盘流式播放（音频线程用几块小缓冲区边解码边播放，不把整首曲子解码进内存），
+// 循环由流内部回绕，首尾无缝。切换曲目时交叉淡入淡出。
+#include <SFML/Audio.hpp>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <string>
+
+class MusicDirector {
+public:
+    enum class Track {
+        Menu,      // 主菜单
+        Gameplay,  // 对局中（可选）
+        None       // 静音
+    };
+
+    // 曲目文件不存在时该曲目保持静音，返回false
+    bool openTrack(Track track, const std::string& path, float volume) {
+        Channel& channel = channels[index(track)];
+        // 先检查文件是否存在：缺失的可选曲目不让SFML往stderr打印打开失败
+        std::error_code error;
+        channel.available = std::filesystem::is_regular_file(path, error) && channel.music.openFromFile(path);
+        channel.volume = volume;
+        if (channel.available) {
+            channel.music.setLooping(true);
+            channel.music.setVolume(0.f);
+        }
+        return channel.available;
+    }
+
+    // 切换到目标曲目（重复调用无副作用），实际音量在update里渐变
+    void play(Track track) { target = track; }
+
+    // 每帧调用：推进淡入淡出
+    void update(float deltaTime) {
+        float step = fadeTime > 0.f ? deltaTime / fadeTime : 1.f;
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            Channel& channel = channels[i];
+            if (!channel.available) {
+                continue;
+            }
+            bool wanted = target != Track::None && i == index(target);
+            channel.mix = std::clamp(channel.mix + (wanted ? step : -step), 0.f, 1.f);
+
+            if (channel.mix > 0.f && channel.music.getStatus() == sf::SoundSource::Status::Stopped) {
+                channel.music.play();
+            }
+            else if (channel.mix == 0.f && channel.music.getStatus() != sf::SoundSource::Status::Stopped) {
+                channel.music.stop();  // 淡出完毕，下次从头播放
+            }
+            channel.music.setVolume(channel.volume * channel.mix);
+        }
+    }
+
+    // 暂停菜单：正在播放的曲目原地暂停，恢复时接着播
+    void pause() {
+        for (Channel& channel : channels) {
+            if (channel.available && channel.music.getStatus() == sf::SoundSource::Status::Playing) {
+                channel.music.pause();
+            }
+        }
+    }
+    void resume() {
+        for (Channel& channel : channels) {
+            if (channel.available && channel.music.getStatus() == sf::SoundSource::Status::Paused) {
+                channel.music.play();
+            }
+        }
+    }
+
+    // 淡入淡出进行中（空闲渲染需要继续逐帧调用update）
+    bool isFading() const {
+        for (std::size_t i = 0; i < channels.size(); ++i) {
+            const Channel& channel = channels[i];
+            bool wanted = target != Track::None && i == index(target);
+            if (channel.available && channel.mix != (wanted ? 1.f : 0.f)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    float fadeTime = 1.0f;  // 交叉淡入淡出时长（秒）
+
+private:
+    struct Channel {
+        sf::Music music;
+        bool available = false;
+        float volume = 100.f;  // 满音量
+        float mix = 0.f;       // 0~1 淡入淡出系数
+    };
+
+    static std::size_t index(Track track) { return static_cast<std::size_t>(track); }
+
+    std::array<Channel, 2> channels;
+    Track target = Track::None;
+};
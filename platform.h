@@ -0,0 +1,23 @@
+﻿#pragma once
+// ========== 平台层 ==========
+// 把平台相关的调用收在这里，pong.cpp 不再直接包含 <windows.h>，在Linux/macOS上也能编译。
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // 不让 windows.h 定义 min/max 宏，与 std::min/std::max 冲突
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#endif
+
+namespace platform {
+
+// 让控制台按UTF-8显示中文日志（其他平台的终端默认就是UTF-8）
+inline void enableUtf8Console() {
+#ifdef _WIN32
+    SetConsoleOutputCP(65001);  // CP_UTF8
+#endif
+}
+
+} // namespace platform
@@ -4,9 +4,18 @@
 #include <string>
 #include <cstdlib>
 #include <cmath>
-#include <iostream>
-#include <windows.h>
 #include <vector>
+#include <optional>
+#include "pong_sim.h"
+#include "frame_capture.h"
+#include "telemetry.h"
+#include "frame_arena.h"
+#include "glyph_atlas.h"
+#include "music_director.h"
+#include "replay_buffer.h"
+#include "logger.h"
+#include "platform.h"
+#include "alloc_tracker.h"  // 以 PONG_ALLOC_TRACKING 编译时统计堆分配（配合 --alloc-check）
 
 // 游戏状态枚举
 enum class GameState {
@@ -14,6 +23,7 @@ enum class GameState {
     Waiting,   // 等待玩家准备
     Countdown, // 准备倒计时
     Playing,   // 游戏中
+    Replay,    // 得分回放（倒带后慢放）
     Paused,    // 暂停状态 ← 新增
     GameOver,  // 游戏结束，等待重新开始
     Victory    // 有玩家获胜
@@ -23,8 +33,55 @@ struct SoundState {
     bool wasPlaying = false;
 };
 
+// 静态界面的可见内容摘要（脏区跟踪）：与上一帧相同时不需要重画
+struct SceneKey {
+    GameState state = GameState::MainMenu;
+    int blinkPhase = 0;
+    bool onePlayerSelected = true;
+    bool onePlayerMode = false;
+    int player1Score = 0;
+    int player2Score = 0;
+
+    bool operator==(const SceneKey& other) const {
+        return state == other.state && blinkPhase == other.blinkPhase &&
+               onePlayerSelected == other.onePlayerSelected && onePlayerMode == other.onePlayerMode &&
+               player1Score == other.player1Score && player2Score == other.player2Score;
+    }
+    bool operator!=(const SceneKey& other) const { return !(*this == other); }
+};
+
+// 静态状态：画面只有2Hz闪烁在变化
+bool isStaticState(GameState state) {
+    return state == GameState::MainMenu || state == GameState::Paused || state == GameState::Waiting ||
+           state == GameState::GameOver || state == GameState::Victory;
+}
+
 bool onePlayerMode = false;  // 初始为双玩家模式
-float aiSpeed = 600.0f;      // AI移动速度
+
+// 逻辑分辨率：游戏里所有坐标都在这个空间，与窗口大小和内部渲染分辨率无关
+constexpr float LOGICAL_WIDTH = pong::ClassicRules::fieldWidth;
+constexpr float LOGICAL_HEIGHT = pong::ClassicRules::fieldHeight;
+constexpr float SCREEN_CENTER_X = LOGICAL_WIDTH / 2;
+
+// 帧率上限：由主循环在 display() 之后自己睡眠，不用 setFramerateLimit
+// （SFML的限帧睡眠在 display() 里，计时会分不清呈现耗时和睡眠）
+constexpr unsigned FRAME_RATE_LIMIT = 240;
+
+// 画面等比缩放到窗口后所占的矩形（窗口像素），多余部分留黑边
+sf::FloatRect letterboxRect(sf::Vector2u windowSize) {
+    float scale = std::min(windowSize.x / LOGICAL_WIDTH, windowSize.y / LOGICAL_HEIGHT);
+    sf::Vector2f size(LOGICAL_WIDTH * scale, LOGICAL_HEIGHT * scale);
+    return sf::FloatRect({ (windowSize.x - size.x) / 2, (windowSize.y - size.y) / 2 }, size);
+}
+
+// 物理标量类型：定义 PONG_FIXED_PHYSICS 时使用Q16.16定点物理，
+// 以固定步长推进，结果与编译器和优化选项无关（锁步联机、回放）
+#ifdef PONG_FIXED_PHYSICS
+using PhysicsNum = pong::Fixed;
+const float PHYSICS_TICK = 1.0f / 240.0f;  // 定点物理的固定步长
+#else
+using PhysicsNum = float;
+#endif
 
 // 粒子结构体
 struct Particle {
@@ -36,10 +93,158 @@ struct Particle {
     float size = 0.0f;
 };
 
-int main() {
-    SetConsoleOutputCP(65001);
-    sf::RenderWindow window(sf::VideoMode({ 800, 600 }), "Pong");
-    window.setFramerateLimit(240);
+// ========== 粒子细节等级调节器 ==========
+// 根据实测的帧耗时（含呈现，不含帧率限制的睡眠）和逻辑耗时调整细节等级，
+// 按等级缩放每次爆炸的粒子数、粒子寿命、圆形边数和粒子总数上限
+struct ParticleGovernor {
+    static constexpr float MIN_LEVEL = 0.1f;
+    static constexpr std::size_t MAX_PARTICLES = 4000;  // 满细节时的粒子总数上限
+
+    float frameBudget = 1.0f / FRAME_RATE_LIMIT;  // 目标帧预算（秒）
+    float tickShare = 0.4f;                       // 逻辑（含粒子更新）最多占帧预算的比例，其余留给渲染和呈现
+    float averageFrameTime = 0.0f;                // 指数平滑后的帧耗时
+    float averageTickTime = 0.0f;                 // 指数平滑后的逻辑耗时
+    float level = 1.0f;                           // 1 = 满细节
+
+    void update(float frameTime, float tickTime) {
+        averageFrameTime += (frameTime - averageFrameTime) * 0.1f;
+        averageTickTime += (tickTime - averageTickTime) * 0.1f;
+
+        // 帧或逻辑任一超出预算就快速降级，两者都富余较多时才缓慢恢复
+        float tickBudget = frameBudget * tickShare;
+        if (averageFrameTime > frameBudget * 0.9f || averageTickTime > tickBudget * 0.9f) {
+            level = std::max(MIN_LEVEL, level - 0.05f);
+        }
+        else if (averageFrameTime < frameBudget * 0.6f && averageTickTime < tickBudget * 0.6f) {
+            level = std::min(1.0f, level + 0.01f);
+        }
+    }
+
+    int emissionCount(int baseCount) const {
+        return std::max(1, static_cast<int>(baseCount * level));
+    }
+    float lifetimeScale() const { return 0.5f + 0.5f * level; }
+    std::size_t particleBudget() const { return static_cast<std::size_t>(MAX_PARTICLES * level); }
+    // 粒子圆形的边数
+    std::size_t pointCount() const {
+        if (level > 0.75f) return 30;
+        if (level > 0.4f) return 12;
+        return 6;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    platform::enableUtf8Console();
+    Logger logger;  // 游戏循环里只入队，格式化和输出在后台线程
+
+    // 命令行参数
+    bool stressParticles = false;  // --stress-particles: 持续爆炸，检验粒子调节器能否守住帧率
+    std::string capturePath;       // --capture <文件>: 录制画面（.y4m 或原始RGBA）
+    long long captureFrameLimit = 0;  // --capture-frames <n>: 录够n帧后退出
+    bool headless = false;         // --headless: 隐藏窗口、自动对战、固定步长，供CI生成视频
+    std::string telemetryPath;     // --telemetry <文件>: 记录击球、得分、AI决策事件
+    bool allocCheck = false;       // --alloc-check: Playing状态热身后每帧都不允许堆分配
+    float renderScale = 1.0f;      // --render-scale <倍数>: 内部渲染分辨率相对800x600的倍数
+    std::string logBinaryPath;     // --log-binary <文件>: 同时写二进制日志（tools/log_reader 解码）
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stress-particles") {
+            stressParticles = true;
+        }
+        else if (arg == "--capture" && i + 1 < argc) {
+            capturePath = argv[++i];
+        }
+        else if (arg == "--capture-frames" && i + 1 < argc) {
+            captureFrameLimit = std::atoll(argv[++i]);
+        }
+        else if (arg == "--headless") {
+            headless = true;
+        }
+        else if (arg == "--telemetry" && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        }
+        else if (arg == "--alloc-check") {
+            allocCheck = true;
+        }
+        else if (arg == "--render-scale" && i + 1 < argc) {
+            renderScale = std::clamp(static_cast<float>(std::atof(argv[++i])), 0.25f, 4.0f);
+        }
+        else if (arg == "--log-level" && i + 1 < argc) {  // --log-level debug|info|warn|error
+            std::string level = argv[++i];
+            logger.setLevel(level == "debug" ? LogLevel::Debug
+                : level == "warn" ? LogLevel::Warn
+                : level == "error" ? LogLevel::Error
+                : LogLevel::Info);
+        }
+        else if (arg == "--log-binary" && i + 1 < argc) {
+            logBinaryPath = argv[++i];
+        }
+    }
+    if (!logBinaryPath.empty() && !logger.openBinarySink(logBinaryPath)) {
+        logger.error("二进制日志打开失败: %s", logBinaryPath);
+    }
+    if (allocCheck && !alloc_tracker::enabled) {
+        logger.error("--alloc-check 需要以 PONG_ALLOC_TRACKING 编译");
+        return -1;
+    }
+    if (captureFrameLimit > 0 && capturePath.empty()) {
+        // 没有录制时帧数永远不会增加，无头运行不会自己退出
+        logger.error("--capture-frames 需要同时指定 --capture <文件>");
+        return -1;
+    }
+    bool autoPlay = headless;  // 左球拍由自动驾驶控制，菜单和准备自动通过
+
+    sf::RenderWindow window(sf::VideoMode({ static_cast<unsigned>(LOGICAL_WIDTH), static_cast<unsigned>(LOGICAL_HEIGHT) }), "Pong");
+    if (headless) {
+        // CI中配合 xvfb 和软件渲染（LIBGL_ALWAYS_SOFTWARE=1）使用
+        window.setVisible(false);
+    }
+
+    // ========== 渲染目标 ==========
+    // 画面按逻辑坐标画到离屏纹理（内部分辨率 = 逻辑分辨率 x renderScale），
+    // 再等比放大到任意大小的窗口；录制也直接读回这张纹理
+    sf::Vector2u sceneSize(static_cast<unsigned>(LOGICAL_WIDTH * renderScale + 0.5f),
+                           static_cast<unsigned>(LOGICAL_HEIGHT * renderScale + 0.5f));
+    sf::RenderTexture sceneTexture;
+    if (!sceneTexture.resize(sceneSize)) {
+        logger.error("离屏渲染目标创建失败！");
+        return -1;
+    }
+    sceneTexture.setSmooth(true);
+    sceneTexture.setView(sf::View(sf::FloatRect({ 0.f, 0.f }, { LOGICAL_WIDTH, LOGICAL_HEIGHT })));
+
+    // ========== 录制系统 ==========
+    // 按录制帧率读回离屏纹理的像素交给后台编码线程（视频为内部分辨率）
+    const unsigned CAPTURE_FPS = 60;
+    bool capturing = !capturePath.empty();
+    FrameCapture frameCapture;
+    float captureTimer = 0.0f;
+    long long capturedFrames = 0;
+    if (capturing) {
+        if (!frameCapture.open(capturePath, sceneSize.x, sceneSize.y, CAPTURE_FPS)) {
+            logger.error("录制初始化失败！");
+            return -1;
+        }
+        logger.info("开始录制: %s", capturePath);
+        if (allocCheck) {
+            // SFML只能经 copyToImage 读回纹理，每个录制帧都会分配，分配检查必然报告这些帧
+            logger.warn("--capture 每帧读回都会分配内存，与 --alloc-check 同时使用时录制帧会被计为分配");
+        }
+    }
+
+    // ========== 遥测 ==========
+    // 事件写入预分配的列式缓冲块，满块交给后台线程压缩写盘
+    TelemetryStream telemetryStream;
+    std::optional<TelemetryRecorder> telemetryRecorder;
+    std::optional<MatchTelemetry> matchTelemetry;
+    if (!telemetryPath.empty()) {
+        if (!telemetryStream.open(telemetryPath)) {
+            logger.error("遥测文件打开失败！");
+            return -1;
+        }
+        telemetryRecorder.emplace(telemetryStream);
+        matchTelemetry.emplace(*telemetryRecorder);
+    }
 
     // ========== 音效系统 ==========
     // 先加载SoundBuffer
@@ -47,44 +252,47 @@ int main() {
     sf::SoundBuffer scoreBuffer;
     sf::SoundBuffer countdownBuffer;
     sf::SoundBuffer victoryBuffer;
-    sf::SoundBuffer backgroundBuffer;
 
-    // 加载音效文件
-    if (!backgroundBuffer.loadFromFile("sound/background.wav")) {
-        std::cout << "背景音效加载失败！" << std::endl;
+    // 背景音乐从磁盘流式播放；对局音乐可选，没有时对局中保持安静
+    MusicDirector musicDirector;
+    if (!musicDirector.openTrack(MusicDirector::Track::Menu, "sound/background.wav", 90.f)) {
+        logger.error("背景音效加载失败！");
         return -1;
     }
+    if (!musicDirector.openTrack(MusicDirector::Track::Gameplay, "sound/gameplay.ogg", 70.f)) {
+        logger.info("未找到 sound/gameplay.ogg，对局中不播放音乐（放入该文件即可启用菜单与对局之间的交叉淡入淡出）");
+    }
+
+    // 加载音效文件
     if (!bounceBuffer.loadFromFile("sound/bounce.wav")) {
-        std::cout << "碰撞音效加载失败！" << std::endl;
+        logger.error("碰撞音效加载失败！");
         return -1;
     }
 
     if (!scoreBuffer.loadFromFile("sound/score.wav")) {
-        std::cout << "得分音效加载失败！" << std::endl;
+        logger.error("得分音效加载失败！");
         return -1;
     }
 
     if (!countdownBuffer.loadFromFile("sound/countdown.wav")) {
-        std::cout << "倒计时音效加载失败！" << std::endl;
+        logger.error("倒计时音效加载失败！");
         return -1;
     }
 
     if (!victoryBuffer.loadFromFile("sound/victory.wav")) {
-        std::cout << "胜利音效加载失败！" << std::endl;
+        logger.error("胜利音效加载失败！");
         return -1;
     }
 
-    std::cout << "所有音效文件加载成功！" << std::endl;
+    logger.info("所有音效文件加载成功！");
 
     // 创建音效对象 - 必须在构造时传入SoundBuffer
-    sf::Sound backgroundSound(backgroundBuffer);
     sf::Sound bounceSound(bounceBuffer);      
     sf::Sound scoreSound(scoreBuffer);        
     sf::Sound countdownSound(countdownBuffer);
     sf::Sound victorySound(victoryBuffer);    
 
     // 设置合适的音量
-    backgroundSound.setVolume(90.f);
     bounceSound.setVolume(70.f);
     scoreSound.setVolume(80.f);
     countdownSound.setVolume(60.f);
@@ -97,86 +305,91 @@ int main() {
     SoundState victorySoundState;
     GameState previousState = GameState::Waiting;  // 记录暂停前的状态
 
-    // 设置背景音乐循环播放
-    backgroundSound.setLooping(true);  // 重要：让背景音乐循环播放
-
     // ========== 菜单图片系统 ==========
     sf::Texture menuBackgroundTexture;
     sf::Sprite menuBackground(menuBackgroundTexture);
 
     // ========== 菜单图片加载 ==========
     if (!menuBackgroundTexture.loadFromFile("image/background.png")) {
-        std::cout << "菜单背景图片加载失败！" << std::endl;
+        logger.error("菜单背景图片加载失败！");
         return -1;
     }
     // 修复：重新设置Sprite的纹理
     menuBackground.setTexture(menuBackgroundTexture, true);
 
     // ========== 字体系统 ==========
+    // 优先使用预烘焙图集（font/ 下已提交，见 tools/bake_glyph_atlas_freetype），缺失时才加载TTF
+    GlyphAtlas glyphAtlas;
     sf::Font font;
-    if (!font.openFromFile("font/Maltais_Learlex.ttf")) {
-        std::cout << "字体加载失败！" << std::endl;
-        return -1;
+    const sf::Font* fallbackFont = nullptr;
+    if (!glyphAtlas.loadFromFile("font/Maltais_Learlex.atlas")) {
+        if (!font.openFromFile("font/Maltais_Learlex.ttf")) {
+            logger.error("字体加载失败！");
+            return -1;
+        }
+        fallbackFont = &font;
+        logger.info("未找到字形图集，使用TTF字体");
     }
+    TextBatch textBatch(glyphAtlas);
     // 创建文本对象
-    sf::Text player1ScoreText(font, "0", 48);
+    AtlasText player1ScoreText(glyphAtlas, fallbackFont, "0", 48);
     player1ScoreText.setFillColor(sf::Color::White);
     player1ScoreText.setPosition({ 297.f, 20.f });
 
-    sf::Text player2ScoreText(font, "0", 48);
+    AtlasText player2ScoreText(glyphAtlas, fallbackFont, "0", 48);
     player2ScoreText.setFillColor(sf::Color::White);
     player2ScoreText.setPosition({ 492.f, 20.f });
 
-    sf::Text separatorText(font, ":", 48);
+    AtlasText separatorText(glyphAtlas, fallbackFont, ":", 48);
     separatorText.setFillColor(sf::Color::White);
     separatorText.setPosition({ 398.f, 20.f });
 
-    sf::Text stateText(font, "", 30);
+    AtlasText stateText(glyphAtlas, fallbackFont, "", 30);
     stateText.setFillColor(sf::Color::Red);
     stateText.setPosition({ 240.f, 80.f });
 
     // 胜利文本对象
-    sf::Text victoryLine1(font, "", 36);
+    AtlasText victoryLine1(glyphAtlas, fallbackFont, "", 36);
     victoryLine1.setFillColor(sf::Color::Red);
 
-    sf::Text victoryLine2(font, "", 24);
+    AtlasText victoryLine2(glyphAtlas, fallbackFont, "", 24);
     victoryLine2.setFillColor(sf::Color::Red);
 
     // 暂停文本对象 - 使用和stateText相同的创建方式
-    sf::Text pauseText1(font, "GAME PAUSED", 36);
+    AtlasText pauseText1(glyphAtlas, fallbackFont, "GAME PAUSED", 36);
     pauseText1.setFillColor(sf::Color::Red);
     sf::FloatRect pauseBounds1 = pauseText1.getLocalBounds();
     pauseText1.setOrigin({ pauseBounds1.size.x / 2, pauseBounds1.size.y / 2 });
-    pauseText1.setPosition({ 400.f, 275.f });
+    pauseText1.setPosition({ SCREEN_CENTER_X, 275.f });
 
-    sf::Text pauseText2(font, "Press ESC to continue", 36);
+    AtlasText pauseText2(glyphAtlas, fallbackFont, "Press ESC to continue", 36);
     pauseText2.setFillColor(sf::Color::Red);
     sf::FloatRect pauseBounds2 = pauseText2.getLocalBounds();
     pauseText2.setOrigin({ pauseBounds2.size.x / 2, pauseBounds2.size.y / 2 });
-    pauseText2.setPosition({ 400.f, 325.f });
+    pauseText2.setPosition({ SCREEN_CENTER_X, 325.f });
 
     // 主菜单文本对象（放在其他文本对象后面）
-    sf::Text titleText(font, "PONG GAME", 60);
+    AtlasText titleText(glyphAtlas, fallbackFont, "PONG GAME", 60);
     titleText.setFillColor(sf::Color::Red);
 
-    sf::Text onePlayerText(font, "1 PLAYER", 36);
+    AtlasText onePlayerText(glyphAtlas, fallbackFont, "1 PLAYER", 36);
     onePlayerText.setFillColor(sf::Color::White);
 
-    sf::Text twoPlayersText(font, "2 PLAYERS", 36);
+    AtlasText twoPlayersText(glyphAtlas, fallbackFont, "2 PLAYERS", 36);
     twoPlayersText.setFillColor(sf::Color::White);
 
     // 主菜单文本位置设置
     sf::FloatRect titleBounds = titleText.getLocalBounds();
     titleText.setOrigin({ titleBounds.size.x / 2, titleBounds.size.y / 2 });
-    titleText.setPosition({ 400.f, 150.f });
+    titleText.setPosition({ SCREEN_CENTER_X, 150.f });
 
     sf::FloatRect onePlayerBounds = onePlayerText.getLocalBounds();
     onePlayerText.setOrigin({ onePlayerBounds.size.x / 2, onePlayerBounds.size.y / 2 });
-    onePlayerText.setPosition({ 400.f, 300.f });
+    onePlayerText.setPosition({ SCREEN_CENTER_X, 300.f });
 
     sf::FloatRect twoPlayersBounds = twoPlayersText.getLocalBounds();
     twoPlayersText.setOrigin({ twoPlayersBounds.size.x / 2, twoPlayersBounds.size.y / 2 });
-    twoPlayersText.setPosition({ 400.f, 370.f });
+    twoPlayersText.setPosition({ SCREEN_CENTER_X, 370.f });
 
     // 按钮选择状态
     bool onePlayerSelected = true;
@@ -185,7 +398,7 @@ int main() {
     // 创建对象...
     // 半透明覆盖层
     sf::RectangleShape overlay;
-    overlay.setSize({ 800.f, 600.f });
+    overlay.setSize({ LOGICAL_WIDTH, LOGICAL_HEIGHT });
     overlay.setFillColor(sf::Color(80, 0, 0, 200)); 
     overlay.setPosition({ 0.f, 0.f });
 
@@ -196,15 +409,15 @@ int main() {
 
     // 加载图片
     if (!leftpaddleTexture.loadFromFile("image/leftpaddle.jpg")) {
-        std::cout << "左球拍图片加载失败！" << std::endl;
+        logger.error("左球拍图片加载失败！");
         return -1;
     }
     if (!rightpaddleTexture.loadFromFile("image/rightpaddle.jpg")) {
-        std::cout << "右球拍图片加载失败！" << std::endl;
+        logger.error("右球拍图片加载失败！");
         return -1;
     }
     if (!ballTexture.loadFromFile("image/ball.jpg")) {
-        std::cout << "小球图片加载失败！" << std::endl;
+        logger.error("小球图片加载失败！");
         return -1;
     }
 
@@ -232,23 +445,19 @@ int main() {
 
     ball.setScale({ ballScaleX, ballScaleY });
 
+    // 对局模拟状态：球拍、球、AI和积分（物理常量见 pong::ClassicRules）
+    pong::BasicMatchState<PhysicsNum> match;
+#ifdef PONG_FIXED_PHYSICS
+    float physicsAccumulator = 0.0f;  // 固定步长剩余时间
+#endif
+
     // 设置初始位置
-    leftPaddle.setPosition({ 50.f, 250.f });
-    rightPaddle.setPosition({ 730.f, 250.f });
+    leftPaddle.setPosition({ pong::toFloat(match.leftPaddle.x), pong::toFloat(match.leftPaddle.y) });
+    rightPaddle.setPosition({ pong::toFloat(match.rightPaddle.x), pong::toFloat(match.rightPaddle.y) });
     ball.setPosition({ 390.f, 295.f });
 
-    // 球拍初始位置（用于重置）
-    sf::Vector2f leftPaddleStartPos(50.f, 250.f);
-    sf::Vector2f rightPaddleStartPos(730.f, 250.f);
-
-    // 改为基于时间的速度（像素/秒）
-    sf::Vector2f ballVelocity(500.0f, 300.0f);
-    float paddleSpeed = 700.0f;
-
-    // 游戏状态和积分
+    // 游戏状态
     GameState gameState = GameState::MainMenu;
-    int player1Score = 0;
-    int player2Score = 0;
 
     // 玩家准备状态
     bool player1Ready = false;
@@ -264,15 +473,17 @@ int main() {
     // 帧计时器
     sf::Clock frameClock;
 
-    // 质量定义
-    const float paddleMass = 400.f; // 球拍质量
-    const float ballMass = 314.f;   // 球质量
+    // ========== 空闲渲染 ==========
+    const float BLINK_INTERVAL = 0.5f;  // 闪烁半周期（2Hz）
+    SceneKey lastSceneKey;
+    bool sceneDirty = true;                  // 强制重画（窗口尺寸变化、重新获得焦点）
+    std::optional<sf::Event> pendingEvent;   // 空闲等待期间收到的事件
 
     // ========== 粒子系统 ==========
     std::vector<Particle> particles;
-    const int PARTICLE_COUNT = 75;      // 每次爆炸的粒子数量
-    const float PARTICLE_LIFETIME = 1.0f; // 粒子存活时间（秒）
-    const float PARTICLE_SPEED = 300.0f;  // 粒子初始速度
+    constexpr int PARTICLE_COUNT = 75;      // 每次爆炸的粒子数量
+    constexpr float PARTICLE_LIFETIME = 1.0f; // 粒子存活时间（秒）
+    constexpr float PARTICLE_SPEED = 300.0f;  // 粒子初始速度
 
     // ========== 爆炸颜色 - 恐怖血液风格 ==========
     sf::Color explosionColors[] = {
@@ -285,21 +496,159 @@ int main() {
         sf::Color(220, 50, 50),     // 动脉血红色
         sf::Color(130, 10, 10)      // 凝固血液色
     };
-    const int COLOR_COUNT = 8;
+    constexpr int COLOR_COUNT = 8;
+
+    ParticleGovernor particleGovernor;
+    particles.reserve(ParticleGovernor::MAX_PARTICLES);
+
+    // ========== 帧内存 ==========
+    // 粒子顶点和格式化文本从这里分配，每帧复位
+    FrameArena frameArena(1 << 20);
+
+    // 文本只在内容变化时重新设置（setString会重建字形顶点并分配内存）
+    int shownPlayer1Score = -1;
+    int shownPlayer2Score = -1;
+    std::string shownStateText;
+    shownStateText.reserve(64);
+    auto setStateText = [&](const char* text) {
+        if (shownStateText != text) {
+            shownStateText = text;
+            stateText.setString(text);
+        }
+    };
+
+    // ========== 即时回放 ==========
+    // 对局中每1/60秒存一份快照，得分后先倒带到几秒前，再慢放到得分瞬间
+    const float REPLAY_CAPTURE_INTERVAL = 1.0f / 60.0f;
+    const float REPLAY_SECONDS = 2.0f;       // 回放得分前的最后几秒
+    const float REPLAY_REWIND_SPEED = 4.0f;  // 倒带倍速
+    const float REPLAY_SLOW_MOTION = 0.4f;   // 慢放倍速
+    ReplayBuffer replayBuffer(4 * 60);       // 保留最近4秒
+    ReplaySnapshot replayStaging;
+    float replayCaptureTimer = 0.0f;
+    float replayCursor = 0.0f;               // 快照下标（可带小数，用于插值）
+    float replayStart = 0.0f;
+    bool replayRewinding = false;
+    bool replaySkip = false;
+    GameState replayNextState = GameState::GameOver;
+
+    // 粒子超过快照容量时均匀抽样
+    auto captureReplay = [&]() {
+        replayStaging.ballX = encodeReplayCoord(pong::toFloat(match.ball.x));
+        replayStaging.ballY = encodeReplayCoord(pong::toFloat(match.ball.y));
+        replayStaging.leftPaddleX = encodeReplayCoord(pong::toFloat(match.leftPaddle.x));
+        replayStaging.leftPaddleY = encodeReplayCoord(pong::toFloat(match.leftPaddle.y));
+        replayStaging.rightPaddleX = encodeReplayCoord(pong::toFloat(match.rightPaddle.x));
+        replayStaging.rightPaddleY = encodeReplayCoord(pong::toFloat(match.rightPaddle.y));
+        std::size_t stride = particles.size() / ReplaySnapshot::MAX_PARTICLES + 1;
+        std::uint16_t count = 0;
+        for (std::size_t i = 0; i < particles.size() && count < ReplaySnapshot::MAX_PARTICLES; i += stride) {
+            const Particle& particle = particles[i];
+            ReplayParticle& out = replayStaging.particles[count++];
+            out.x = encodeReplayCoord(particle.position.x);
+            out.y = encodeReplayCoord(particle.position.y);
+            out.r = particle.color.r;
+            out.g = particle.color.g;
+            out.b = particle.color.b;
+            out.a = static_cast<std::uint8_t>(particle.lifetime / particle.maxLifetime * 255);
+            out.size = static_cast<std::uint8_t>(particle.size);
+        }
+        replayStaging.particleCount = count;
+        replayBuffer.push(replayStaging);
+    };
 
-    float aiDecisionTimer = 0.0f;
-    const float AI_DECISION_INTERVAL = 0.25f;
-    float aiCurrentDirection1 = 0.0f;
-    float aiCurrentDirection2 = 0.0f;
+    // 分配检查：Playing状态连续一段时间后开始计数
+    const int ALLOC_WARMUP_FRAMES = 120;
+    const int ALLOC_CHECK_FRAMES = 3000;  // 无头运行检查这么多帧后退出（CTest 的 pong_alloc_check）
+    int playingFrames = 0;
+    long long allocatingFrames = 0;
+
+    // 压力测试计时
+    float stressSpawnTimer = 0.0f;
+    float stressReportTimer = 0.0f;
+    int stressFrames = 0;
+
+    // 模拟事件钩子：音效、粒子爆炸和遥测（未开启遥测时telemetry为空）
+    struct GameHooks {
+        sf::Sound& bounceSound;
+        sf::Sound& scoreSound;
+        std::vector<Particle>& particles;
+        const sf::Color* colors;
+        const ParticleGovernor& governor;
+        MatchTelemetry* telemetry;
+
+        void onWallBounce() {
+            bounceSound.play();
+            if (telemetry) telemetry->wallBounce();
+        }
+        void onPaddleHit(int player, float hitRatio, pong::Vec2<float> velocity) {
+            bounceSound.play();
+            if (telemetry) telemetry->paddleHit(player, hitRatio, velocity.x, velocity.y);
+        }
+        void onAiDecision(float distance) {
+            if (telemetry) telemetry->aiDecision(distance);
+        }
+        void onScore(int player, pong::Vec2<float> ballPosition) {
+            scoreSound.play();
+            explode({ ballPosition.x, ballPosition.y });
+            if (telemetry) telemetry->score(player);
+        }
+
+        // 创建爆炸粒子（数量和寿命由调节器决定，不超过粒子总数上限）
+        void explode(sf::Vector2f explosionPos) {
+            std::size_t budget = governor.particleBudget();
+            int count = governor.emissionCount(PARTICLE_COUNT);
+            float lifetimeScale = governor.lifetimeScale();
+            for (int i = 0; i < count && particles.size() < budget; ++i) {
+                Particle p;
+                p.position = explosionPos;
+                // 随机方向
+                float angle = (std::rand() % 628) / 100.0f; // 0-2π
+                float speed = (std::rand() % 100) / 100.0f * PARTICLE_SPEED + 100.0f;
+                p.velocity = sf::Vector2f(std::cos(angle) * speed, std::sin(angle) * speed);
+                p.color = colors[std::rand() % COLOR_COUNT];
+                p.lifetime = p.maxLifetime = PARTICLE_LIFETIME * lifetimeScale * (0.5f + (std::rand() % 100) / 200.0f);
+                p.size = static_cast<float>(std::rand() % 5 + 2);
+                particles.push_back(p);
+            }
+        }
+    };
+    GameHooks hooks{ bounceSound, scoreSound, particles, explosionColors, particleGovernor,
+        matchTelemetry ? &*matchTelemetry : nullptr };
+
+    sf::Clock workClock;        // 本帧实际工作耗时（含呈现，不含帧率限制的睡眠）
+    sf::Clock frameLimitClock;  // 距上次呈现的时间，用于限帧
 
     while (window.isOpen()) {
         float deltaTime = frameClock.restart().asSeconds();
+        workClock.restart();
+        frameArena.reset();
+        GameState frameStartState = gameState;
+        std::uint64_t frameStartAllocations = alloc_tracker::allocationCount();
+        if (headless) {
+            deltaTime = 1.0f / CAPTURE_FPS;  // 无头录制：每帧固定步长，视频与机器速度无关
+        }
 
-        // 事件处理
-        while (auto event = window.pollEvent()) {
+        // 事件处理（先处理空闲等待时收到的事件）
+        auto nextEvent = [&]() -> std::optional<sf::Event> {
+            if (pendingEvent) {
+                std::optional<sf::Event> event = std::move(pendingEvent);
+                pendingEvent.reset();
+                return event;
+            }
+            return window.pollEvent();
+        };
+        while (auto event = nextEvent()) {
             if (event->is<sf::Event::Closed>()) {
                 window.close();
             }
+            if (auto resized = event->getIf<sf::Event::Resized>()) {
+                // 窗口视图保持像素坐标，画面的缩放和黑边在呈现时计算
+                window.setView(sf::View(sf::FloatRect({ 0.f, 0.f }, sf::Vector2f(resized->size))));
+            }
+            if (event->is<sf::Event::Resized>() || event->is<sf::Event::FocusGained>()) {
+                sceneDirty = true;
+            }
             // ESC键暂停功能
             if (event->is<sf::Event::KeyPressed>()) {
                 auto keyEvent = event->getIf<sf::Event::KeyPressed>();
@@ -320,8 +669,9 @@ int main() {
                         bounceSound.stop();
                         scoreSound.stop();
                         victorySound.stop();
+                        musicDirector.pause();
 
-                        std::cout << "游戏暂停" << std::endl;
+                        logger.info("游戏暂停");
                     }
                     // 恢复时重新播放音效
                     else if (gameState == GameState::Paused) {
@@ -340,39 +690,68 @@ int main() {
                         if (victorySoundState.wasPlaying) {
                             victorySound.play();
                         }
+                        musicDirector.resume();
 
-                        std::cout << "游戏继续" << std::endl;
+                        logger.info("游戏继续");
+                    }
+                    // 回放中ESC直接跳过回放
+                    else if (gameState == GameState::Replay) {
+                        replaySkip = true;
                     }
                 }
+                // 回放中按空格或回车跳过。不用方向键：得分时玩家往往还按着移动键，
+                // 系统的按键重复会立刻送来KeyPressed，把回放误跳过
+                else if (keyEvent && gameState == GameState::Replay &&
+                         (keyEvent->code == sf::Keyboard::Key::Space || keyEvent->code == sf::Keyboard::Key::Enter)) {
+                    replaySkip = true;
+                }
             }
         }
         // 更新闪烁计时器
         blinkTimer += deltaTime;
 
-        // ========== 更新粒子系统 ==========
-        for (auto it = particles.begin(); it != particles.end();) {
-            it->lifetime -= deltaTime;
-            if (it->lifetime <= 0) {
-                it = particles.erase(it);
+        // 背景音乐淡入淡出
+        musicDirector.update(deltaTime);
+
+        // ========== 压力测试：持续爆炸 ==========
+        if (stressParticles) {
+            stressSpawnTimer -= deltaTime;
+            while (stressSpawnTimer <= 0.0f) {
+                hooks.explode({ static_cast<float>(std::rand() % static_cast<int>(LOGICAL_WIDTH)),
+                                static_cast<float>(std::rand() % static_cast<int>(LOGICAL_HEIGHT)) });
+                stressSpawnTimer += 0.02f;
             }
-            else {
+        }
+
+        // ========== 更新粒子系统 ==========
+        // 原地压缩删除死亡粒子，避免逐个erase的O(n²)搬移
+        std::size_t aliveCount = 0;
+        for (std::size_t i = 0; i < particles.size(); ++i) {
+            Particle& particle = particles[i];
+            particle.lifetime -= deltaTime;
+            if (particle.lifetime > 0) {
                 // 更新粒子位置
-                it->position += it->velocity * deltaTime;
+                particle.position += particle.velocity * deltaTime;
                 // 添加重力效果
-                it->velocity.y += 500.0f * deltaTime;
-                ++it;
+                particle.velocity.y += 500.0f * deltaTime;
+                particles[aliveCount++] = particle;
             }
         }
+        particles.resize(aliveCount);
 
         // ========== 更新文本内容 ==========
-        player1ScoreText.setString(std::to_string(player1Score));
-        player2ScoreText.setString(std::to_string(player2Score));
+        if (match.player1Score != shownPlayer1Score) {
+            shownPlayer1Score = match.player1Score;
+            player1ScoreText.setString(frameArena.format("%d", shownPlayer1Score));
+        }
+        if (match.player2Score != shownPlayer2Score) {
+            shownPlayer2Score = match.player2Score;
+            player2ScoreText.setString(frameArena.format("%d", shownPlayer2Score));
+        }
 
         if (gameState == GameState::MainMenu) {
             // 主菜单状态
-            if (backgroundSound.getStatus() != sf::SoundSource::Status::Playing) {
-                backgroundSound.play();
-            }
+            musicDirector.play(MusicDirector::Track::Menu);
             // 上下键选择
             if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up)) {
                 onePlayerSelected = true;
@@ -381,18 +760,21 @@ int main() {
                 onePlayerSelected = false;
             }
 
-            // 回车键确认选择
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter)) {
+            // 回车键确认选择（自动对战直接进入单玩家模式）
+            if (autoPlay) {
+                onePlayerSelected = true;
+            }
+            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter) || autoPlay) {
                 if (onePlayerSelected) {
-                    std::cout << "选择单玩家模式" << std::endl;
+                    logger.info("选择单玩家模式");
                     onePlayerMode = true;
-                    backgroundSound.stop();
+                    musicDirector.play(MusicDirector::Track::Gameplay);
                     gameState = GameState::Waiting;
                 }
                 else {
-                    std::cout << "选择双玩家模式" << std::endl;
+                    logger.info("选择双玩家模式");
                     onePlayerMode = false;
-                    backgroundSound.stop();
+                    musicDirector.play(MusicDirector::Track::Gameplay);
                     gameState = GameState::Waiting;
                 }
             }
@@ -411,24 +793,28 @@ int main() {
 
         else if (gameState == GameState::Waiting) {
             if (onePlayerMode) {
-                stateText.setString("Press WASD Keys to Ready");
+                setStateText("Press WASD Keys to Ready");
                 stateText.setPosition({ 275.f, 80.f });
             }
             
             else { 
-                stateText.setString("Press WASD or Arrow Keys to Ready"); 
+                setStateText("Press WASD or Arrow Keys to Ready"); 
             }
         }
         else if (gameState == GameState::Countdown) {
-            stateText.setString("Starting: " + std::to_string(static_cast<int>(countdownTimer + 0.5f)));
+            setStateText(frameArena.format("Starting: %d", static_cast<int>(countdownTimer + 0.5f)));
             stateText.setPosition({ 355.f, 80.f });
         }
         else if (gameState == GameState::Playing) {
-            stateText.setString("Playing");
+            setStateText("Playing");
             stateText.setPosition({ 370.f, 80.f });
         }
+        else if (gameState == GameState::Replay) {
+            setStateText(replayRewinding ? "Rewind: SPACE to skip" : "Replay: SPACE to skip");
+            stateText.setPosition({ 300.f, 80.f });
+        }
         else if (gameState == GameState::GameOver) {
-            stateText.setString("Press any move key to continue");
+            setStateText("Press any move key to continue");
             stateText.setPosition({ 260.f, 80.f });
         }
         else if (gameState == GameState::Victory) {
@@ -458,7 +844,8 @@ int main() {
             // 等待玩家准备状态
 
             // 玩家1准备（按任意移动键：W、S、A、D）
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
+            if (autoPlay ||
+                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) {
@@ -474,11 +861,11 @@ int main() {
             }
 
             // 两个玩家都准备好，开始倒计时
-            if (player1Ready && player2Ready && !onePlayerMode || player1Ready && onePlayerMode) {
+            if (player1Ready && (player2Ready || onePlayerMode)) {
                 countdownSound.play();  // 播放倒计时音效
                 gameState = GameState::Countdown;
                 countdownTimer = COUNTDOWN_DURATION;
-                printf("游戏将在 %.1f 秒后开始...\n", countdownTimer);
+                logger.info("游戏将在 %.1f 秒后开始...", countdownTimer);
             }
 
         }
@@ -491,376 +878,140 @@ int main() {
             if (!soundPlayed) {
                 countdownSound.play();
                 soundPlayed = true;
-                std::cout << "播放倒计时音效" << std::endl;
+                logger.debug("播放倒计时音效");
             }
 
             // 更新倒计时显示
             int remainingSeconds = static_cast<int>(countdownTimer + 0.5f);
-            stateText.setString("Starting: " + std::to_string(remainingSeconds));
+            setStateText(frameArena.format("Starting: %d", remainingSeconds));
 
             // 倒计时结束，开始游戏
             if (countdownTimer <= 0.0f) {
                 gameState = GameState::Playing;
                 soundPlayed = false;  // 重置为下次使用
-                ball.setPosition({ 395.f, 295.f });
-
-                // 随机角度（0 到 2π）
-                float angle = (std::rand() % 628) / 100.0f;
+                pong::serveBall(match);
 
-                while (std::abs(std::cos(angle)) < 0.3f || std::abs(std::cos(angle)) > 0.9f) {
-                    angle = (std::rand() % 628) / 100.0f;
-                }
+                // 每个回合重新开始记录回放
+                replayBuffer.clear();
+                replayCaptureTimer = 0.0f;
+                captureReplay();
 
-                float speed = 500.0f;
-                ballVelocity.x = std::cos(angle) * speed;
-                ballVelocity.y = std::sin(angle) * speed;
-
-                printf("游戏开始！\n");
+                logger.info("游戏开始！");
             }
         }
         else if (gameState == GameState::Playing) {
             // ========== 基于时间的运动系统 ==========
-
-            // 球拍移动（基于时间）
-            // 玩家1控制 - 左球拍
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W)) {
-                leftPaddle.move({ 0.f, -paddleSpeed * deltaTime });
-                if (leftPaddle.getPosition().y < 0) {
-                    leftPaddle.setPosition({ leftPaddle.getPosition().x, 0.f });
-                }
-            }
-
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S)) {
-                leftPaddle.move({ 0.f, paddleSpeed * deltaTime });
-                if (leftPaddle.getPosition().y + leftPaddle.getGlobalBounds().size.y > 600) {
-                    leftPaddle.setPosition({ leftPaddle.getPosition().x, 600.f - leftPaddle.getGlobalBounds().size.y });
-                }
+            // 玩家1控制 - 左球拍（WASD），玩家2控制 - 右球拍（方向键）
+            pong::PaddleInput player1Input{
+                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W),
+                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S),
+                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A),
+                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D) };
+            if (autoPlay) {
+                player1Input = pong::autoPilotInput(match, 1);
             }
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A)) {
-                leftPaddle.move({ -paddleSpeed * deltaTime, 0.f });
-                if (leftPaddle.getPosition().x < 0) {
-                    leftPaddle.setPosition({ 0.f, leftPaddle.getPosition().y });
-                }
+            pong::PaddleInput player2Input;
+            if (!onePlayerMode) {
+                player2Input = {
+                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up),
+                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down),
+                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left),
+                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right) };
             }
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) {
-                leftPaddle.move({ paddleSpeed * deltaTime, 0.f });
-                if (leftPaddle.getPosition().x + leftPaddle.getGlobalBounds().size.x > 400) {
-                    leftPaddle.setPosition({ 400.f - leftPaddle.getGlobalBounds().size.x, leftPaddle.getPosition().y });
-                }
-            }
-            if (onePlayerMode) {
-                // ========== 每0.25秒检测的AI控制系统 ==========
-
-                aiDecisionTimer -= deltaTime;
-
-                // 每0.25秒做一次决策
-                if (aiDecisionTimer <= 0.0f) {
-                    float ballCenterY = ball.getPosition().y + ball.getGlobalBounds().size.y / 2;
-                    float paddleCenterY = rightPaddle.getPosition().y + rightPaddle.getGlobalBounds().size.y / 2;
 
-                    // 计算目标方向
-                    float distance = ballCenterY - paddleCenterY;
-
-                    // 智能速度调节：距离越远，移动越快
-                    if (std::abs(distance) > 50.0f) {
-                        aiCurrentDirection1 = (distance > 0) ? 1.0f : -1.0f;  
-                    }
-                    else  {
-                        aiCurrentDirection1 = (distance > 0) ? 0.6f : -0.6f;  
-                    }
-                    if (ball.getPosition().x > 400.f ) {
-						aiCurrentDirection2 = (ballVelocity.x > 0) ? -1.0f : 0.5f;
-                    }
-                    else {
-                        aiCurrentDirection2 = (ballVelocity.x > 0) ? -0.6f : 0.3f;
-                    }
-                    if (rightPaddle.getPosition().x < ball.getPosition().x) {
-                        aiCurrentDirection2 = 1.5f;
-                    }
-                    aiDecisionTimer = AI_DECISION_INTERVAL; // 重置计时器
-                    
-                }
-
-                // 持续应用移动（保持平滑）
-                rightPaddle.move({ 0.f, aiCurrentDirection1 * aiSpeed * deltaTime });
-
-                rightPaddle.move({ aiCurrentDirection2 * aiSpeed * deltaTime, 0.f });
-
-                // AI边界检测（保持不变）
-                if (rightPaddle.getPosition().y < 0) {
-                    rightPaddle.setPosition({ rightPaddle.getPosition().x, 0.f });
-                    aiCurrentDirection1 = 0.0f; // 碰到边界时停止
-                }
-                if (rightPaddle.getPosition().y + rightPaddle.getGlobalBounds().size.y > 600) {
-                    rightPaddle.setPosition({ rightPaddle.getPosition().x, 600.f - rightPaddle.getGlobalBounds().size.y });
-                    aiCurrentDirection1 = 0.0f; // 碰到边界时停止
+            // 模式只在这里判断一次，两种模式各自走编译期特化的模拟步骤
+            auto stepPhysics = [&](PhysicsNum dt) {
+                if (matchTelemetry) {
+                    matchTelemetry->advanceTick();
                 }
-                if (rightPaddle.getPosition().x < 400) {
-                    rightPaddle.setPosition({ 400.f, rightPaddle.getPosition().y });
-                }
-                if (rightPaddle.getPosition().x + rightPaddle.getGlobalBounds().size.x > 800) {
-                    rightPaddle.setPosition({ 800.f - rightPaddle.getGlobalBounds().size.x, rightPaddle.getPosition().y });
+                if (onePlayerMode) {
+                    return pong::stepPlaying<pong::PlayerMode::OnePlayer>(match, player1Input, player2Input, dt, hooks);
                 }
+                return pong::stepPlaying<pong::PlayerMode::TwoPlayers>(match, player1Input, player2Input, dt, hooks);
+            };
+
+            int scorer = 0;
+#ifdef PONG_FIXED_PHYSICS
+            physicsAccumulator += deltaTime;
+            while (scorer == 0 && physicsAccumulator >= PHYSICS_TICK) {
+                physicsAccumulator -= PHYSICS_TICK;
+                scorer = stepPhysics(PhysicsNum(PHYSICS_TICK));
             }
-            else {
-                // 玩家2控制 - 右球拍
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up)) {
-                    rightPaddle.move({ 0.f, -paddleSpeed * deltaTime });
-                    if (rightPaddle.getPosition().y < 0) {
-                        rightPaddle.setPosition({ rightPaddle.getPosition().x, 0.f });
-                    }
-                }
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down)) {
-                    rightPaddle.move({ 0.f, paddleSpeed * deltaTime });
-                    if (rightPaddle.getPosition().y + rightPaddle.getGlobalBounds().size.y > 600) {
-                        rightPaddle.setPosition({ rightPaddle.getPosition().x, 600.f - rightPaddle.getGlobalBounds().size.y });
-                    }
-                }
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left)) {
-                    rightPaddle.move({ -paddleSpeed * deltaTime, 0.f });
-                    if (rightPaddle.getPosition().x < 400) {
-                        rightPaddle.setPosition({ 400.f, rightPaddle.getPosition().y });
-                    }
-                }
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right)) {
-                    rightPaddle.move({ paddleSpeed * deltaTime, 0.f });
-                    if (rightPaddle.getPosition().x + rightPaddle.getGlobalBounds().size.x > 800) {
-                        rightPaddle.setPosition({ 800.f - rightPaddle.getGlobalBounds().size.x, rightPaddle.getPosition().y });
-                    }
-                }
+            if (scorer != 0) {
+                physicsAccumulator = 0.0f;
+            }
+#else
+            scorer = stepPhysics(deltaTime);
+#endif
+
+            // 记录回放快照（得分瞬间总要记一帧）
+            replayCaptureTimer += deltaTime;
+            if (scorer != 0 || replayCaptureTimer >= REPLAY_CAPTURE_INTERVAL) {
+                replayCaptureTimer = std::min(replayCaptureTimer - REPLAY_CAPTURE_INTERVAL, REPLAY_CAPTURE_INTERVAL);
+                captureReplay();
             }
 
-            // 球移动（基于时间）
-            ball.move(ballVelocity * deltaTime);
-
-            // 碰撞检测
-            sf::FloatRect ballBounds = ball.getGlobalBounds();
-
-            // 上下边界碰撞
-
-            if (ballBounds.position.y <= 0) {
-                bounceSound.play();  // 播放碰撞音效
-                ballVelocity.y = std::abs(ballVelocity.y) * 0.8f;  // 确保向下
-                ballVelocity.x *= 0.9f;
-                // 位置修正
-                ball.setPosition({ ball.getPosition().x, 0.f });
-                ballBounds = ball.getGlobalBounds();
-            }
-            else if (ballBounds.position.y + ballBounds.size.y >= 600) {
-                bounceSound.play();  // 播放碰撞音效
-                ballVelocity.y = -std::abs(ballVelocity.y) * 0.8f;; // 确保向上
-                ballVelocity.x *= 0.9f;
-                // 位置修正
-                ball.setPosition({ ball.getPosition().x, 600.f - ballBounds.size.y });
-                ballBounds = ball.getGlobalBounds();
-            }
-
-            // 左右边界 - 得分 + 粒子爆炸
-            if (ballBounds.position.x <= 0) {
-                scoreSound.play();  // 播放得分音效
-                // 创建爆炸粒子
-                sf::Vector2f explosionPos = ball.getPosition();
-                for (int i = 0; i < PARTICLE_COUNT; ++i) {
-                    Particle p;
-                    p.position = explosionPos;
-                    // 随机方向
-                    float angle = (std::rand() % 628) / 100.0f; // 0-2π
-                    float speed = (std::rand() % 100) / 100.0f * PARTICLE_SPEED + 100.0f;
-                    p.velocity = sf::Vector2f(std::cos(angle) * speed, std::sin(angle) * speed);
-                    p.color = explosionColors[std::rand() % COLOR_COUNT];
-                    p.lifetime = p.maxLifetime = PARTICLE_LIFETIME * (0.5f + (std::rand() % 100) / 200.0f);
-                    p.size = static_cast<float>(std::rand() % 5 + 2);
-                    particles.push_back(p);
-                }
-
-                player2Score++;
+            // 得分后先回放，回放结束再进入GameOver/Victory
+            if (scorer != 0) {
+                int winnerScore = (scorer == 1) ? match.player1Score : match.player2Score;
 
                 // 添加胜利条件判断
-                if (player2Score >= 9) {
-                    gameState = GameState::Victory;
-                    if (onePlayerMode) {
+                if (winnerScore >= pong::ClassicRules::winningScore) {
+                    replayNextState = GameState::Victory;
+                    if (scorer == 1) {
+                        victoryLine1.setString("Player 1 Wins!");
+                    }
+                    else if (onePlayerMode) {
                         victoryLine1.setString("Computer Wins!");
                     }
                     else {
                         victoryLine1.setString("Player 2 Wins!");
                     }
                     victoryLine2.setString("Press any move key to continue");
-                    // 分别居中每一行
-                    sf::FloatRect bounds1 = victoryLine1.getLocalBounds();
-                    victoryLine1.setOrigin({ bounds1.size.x / 2, bounds1.size.y / 2 });
-                    victoryLine1.setPosition({ 400.f, 180.f });
-
-                    sf::FloatRect bounds2 = victoryLine2.getLocalBounds();
-                    victoryLine2.setOrigin({ bounds2.size.x / 2, bounds2.size.y / 2 });
-                    victoryLine2.setPosition({ 400.f, 230.f });
-
-                    victorySound.play(); // 播放胜利音效
-                }
-                else {
-                    gameState = GameState::GameOver;
-                }
-
-                leftPaddle.setPosition(leftPaddleStartPos);
-                rightPaddle.setPosition(rightPaddleStartPos);
-                printf("玩家2得分! 当前比分: %d - %d\n", player1Score, player2Score);
-            }
-            else if (ballBounds.position.x + ballBounds.size.x >= 800) {
-                scoreSound.play();  // 播放得分音效
-                // 创建爆炸粒子
-                sf::Vector2f explosionPos = ball.getPosition();
-                for (int i = 0; i < PARTICLE_COUNT; ++i) {
-                    Particle p;
-                    p.position = explosionPos;
-                    // 随机方向
-                    float angle = (std::rand() % 628) / 100.0f; // 0-2π
-                    float speed = (std::rand() % 100) / 100.0f * PARTICLE_SPEED + 100.0f;
-                    p.velocity = sf::Vector2f(std::cos(angle) * speed, std::sin(angle) * speed);
-                    p.color = explosionColors[std::rand() % COLOR_COUNT];
-                    p.lifetime = p.maxLifetime = PARTICLE_LIFETIME * (0.5f + (std::rand() % 100) / 200.0f);
-                    p.size = static_cast<float>(std::rand() % 5 + 2);
-                    particles.push_back(p);
-                }
-
-                player1Score++;
-
-                // 添加胜利条件判断
-                if (player1Score >= 9) {
-                    gameState = GameState::Victory;
-                    victoryLine1.setString("Player 1 Wins!");
-                    victoryLine2.setString("Press any move key to continue");
 
                     // 分别居中每一行
                     sf::FloatRect bounds1 = victoryLine1.getLocalBounds();
                     victoryLine1.setOrigin({ bounds1.size.x / 2, bounds1.size.y / 2 });
-                    victoryLine1.setPosition({ 400.f, 180.f });
+                    victoryLine1.setPosition({ SCREEN_CENTER_X, 180.f });
 
                     sf::FloatRect bounds2 = victoryLine2.getLocalBounds();
                     victoryLine2.setOrigin({ bounds2.size.x / 2, bounds2.size.y / 2 });
-                    victoryLine2.setPosition({ 400.f, 230.f });
-
-                    victorySound.play(); // 播放胜利音效
+                    victoryLine2.setPosition({ SCREEN_CENTER_X, 230.f });
                 }
                 else {
-                    gameState = GameState::GameOver;
+                    replayNextState = GameState::GameOver;
                 }
 
-                leftPaddle.setPosition(leftPaddleStartPos);
-                rightPaddle.setPosition(rightPaddleStartPos);
-                printf("玩家1得分! 当前比分: %d - %d\n", player1Score, player2Score);
-            }
+                logger.info("玩家%d得分! 当前比分: %d - %d", scorer, match.player1Score, match.player2Score);
 
-            // 球拍碰撞检测 - 使用动量定理和位置相关速度变化
-            auto leftIntersection = leftPaddle.getGlobalBounds().findIntersection(ballBounds);
-            if (leftIntersection.has_value()) {
-                bounceSound.play();  // 播放碰撞音效
-                float totalMass = paddleMass + ballMass;
-
-                // X方向：动量定理
-                float leftPaddleVelocityX = 0.f;
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A))
-                    leftPaddleVelocityX = -paddleSpeed;
-                else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D))
-                    leftPaddleVelocityX = paddleSpeed;
-
-                ballVelocity.x = (ballMass - paddleMass) / totalMass * ballVelocity.x +
-                    (2 * paddleMass) / totalMass * leftPaddleVelocityX;
-
-                // Y方向：基于击中位置的速度变化（合并后的公式）
-                float ballCenterY = ball.getPosition().y + ball.getGlobalBounds().size.x / 2;
-                float hitRatio = (ballCenterY - leftPaddle.getPosition().y) / leftPaddle.getGlobalBounds().size.y;
-                hitRatio = std::clamp(hitRatio, 0.0f, 1.0f);
-                float hitPosition = hitRatio - 0.5f;
-
-                // 统一的速度变化系数公式
-                float speedChangeFactor = 4.0f * std::abs(hitPosition) - 1.0f;
-                float baseSpeedChange = std::abs(ballVelocity.y) * 0.4f;
-
-                // 应用速度变化（保持原方向）
-                if (ballVelocity.y >= 0) {
-                    ballVelocity.y += speedChangeFactor * baseSpeedChange;
-                }
-                else {
-                    ballVelocity.y -= speedChangeFactor * baseSpeedChange;
-                }
-
-                // 速度限制
-                float minYSpeed = 100.0f;
-                float maxYSpeed = 600.0f;
-                if (std::abs(ballVelocity.y) > maxYSpeed) {
-                    ballVelocity.y = (ballVelocity.y > 0) ? maxYSpeed : -maxYSpeed;
-                }
-                if (std::abs(ballVelocity.y) < minYSpeed) {
-                    ballVelocity.y = (ballVelocity.y > 0) ? minYSpeed : -minYSpeed;
-                }
-
-                // 确保球向右运动并修正位置
-                ballVelocity.x = std::abs(ballVelocity.x);
-                ball.setPosition({
-                    leftPaddle.getPosition().x + leftPaddle.getGlobalBounds().size.x + 1.f,
-                    ball.getPosition().y
-                    });
-                ballBounds = ball.getGlobalBounds();
+                float lastSnapshot = static_cast<float>(replayBuffer.size() - 1);
+                replayStart = std::max(0.0f, lastSnapshot - REPLAY_SECONDS / REPLAY_CAPTURE_INTERVAL);
+                replayCursor = lastSnapshot;
+                replayRewinding = true;
+                replaySkip = false;
+                gameState = GameState::Replay;
             }
-
-            auto rightIntersection = rightPaddle.getGlobalBounds().findIntersection(ballBounds);
-            if (rightIntersection.has_value()) {
-                bounceSound.play();  // 播放碰撞音效
-                float totalMass = paddleMass + ballMass;
-
-                // X方向：动量定理
-                float rightPaddleVelocityX = 0.f;
-                if (onePlayerMode) {
-                    // 单人模式：AI控制的球拍X速度 = AI方向 * AI速度
-                    rightPaddleVelocityX = aiCurrentDirection2 * aiSpeed;
-                }
-                else {
-                    // 双人模式：玩家控制
-                    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left))
-                        rightPaddleVelocityX = -paddleSpeed;
-                    else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right))
-                        rightPaddleVelocityX = paddleSpeed;
-                }
-
-                ballVelocity.x = (ballMass - paddleMass) / totalMass * ballVelocity.x +
-                    (2 * paddleMass) / totalMass * rightPaddleVelocityX;
-
-                // Y方向：基于击中位置的速度变化（合并后的公式）
-                float ballCenterY = ball.getPosition().y + ball.getGlobalBounds().size.x / 2;
-                float hitRatio = (ballCenterY - rightPaddle.getPosition().y) / rightPaddle.getGlobalBounds().size.y;
-                hitRatio = std::clamp(hitRatio, 0.0f, 1.0f);
-                float hitPosition = hitRatio - 0.5f;
-
-                // 统一的速度变化系数公式
-                float speedChangeFactor = 4.0f * std::abs(hitPosition) - 1.0f;
-                float baseSpeedChange = std::abs(ballVelocity.y) * 0.4f;
-
-                // 应用速度变化（保持原方向）
-                if (ballVelocity.y >= 0) {
-                    ballVelocity.y += speedChangeFactor * baseSpeedChange;
-                }
-                else {
-                    ballVelocity.y -= speedChangeFactor * baseSpeedChange;
+        }
+        else if (gameState == GameState::Replay) {
+            float snapshotsPerSecond = 1.0f / REPLAY_CAPTURE_INTERVAL;
+            float lastSnapshot = static_cast<float>(replayBuffer.size() - 1);
+            if (replayRewinding) {
+                replayCursor -= deltaTime * snapshotsPerSecond * REPLAY_REWIND_SPEED;
+                if (replayCursor <= replayStart) {
+                    replayCursor = replayStart;
+                    replayRewinding = false;
                 }
+            }
+            else {
+                replayCursor = std::min(lastSnapshot, replayCursor + deltaTime * snapshotsPerSecond * REPLAY_SLOW_MOTION);
+            }
 
-                // 速度限制
-                float minYSpeed = 100.0f;
-                float maxYSpeed = 600.0f;
-                if (std::abs(ballVelocity.y) > maxYSpeed) {
-                    ballVelocity.y = (ballVelocity.y > 0) ? maxYSpeed : -maxYSpeed;
-                }
-                if (std::abs(ballVelocity.y) < minYSpeed) {
-                    ballVelocity.y = (ballVelocity.y > 0) ? minYSpeed : -minYSpeed;
+            if (replaySkip || (!replayRewinding && replayCursor >= lastSnapshot)) {
+                gameState = replayNextState;
+                if (gameState == GameState::Victory) {
+                    victorySound.play(); // 播放胜利音效
                 }
-
-                // 确保球向左运动并修正位置
-                ballVelocity.x = -std::abs(ballVelocity.x);
-                ball.setPosition({
-                    rightPaddle.getPosition().x - ball.getGlobalBounds().size.x / 2 * 2 - 1.f,
-                    ball.getPosition().y
-                    });
-                ballBounds = ball.getGlobalBounds();
             }
-
         }
         else if (gameState == GameState::Paused) {
                 if (static_cast<int>(blinkTimer * 2) % 2 == 0) {
@@ -874,7 +1025,8 @@ int main() {
             // 游戏结束状态
             static bool soundPlayed = false;
             soundPlayed = false;
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
+            if (autoPlay ||
+                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) {
@@ -888,17 +1040,18 @@ int main() {
                 player2Ready = true;
             }
 
-            if (player1Ready && player2Ready && !onePlayerMode || player1Ready && onePlayerMode) {
+            if (player1Ready && (player2Ready || onePlayerMode)) {
                 gameState = GameState::Countdown;
                 countdownTimer = COUNTDOWN_DURATION;
                 player1Ready = false;
                 player2Ready = false;
-                printf("游戏将在 %.1f 秒后继续...\n", countdownTimer);
+                logger.info("游戏将在 %.1f 秒后继续...", countdownTimer);
             }
         }
         else if (gameState == GameState::Victory) {
             // 胜利状态 - 与GameOver状态处理一致
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
+            if (autoPlay ||
+                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) ||
                 sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) {
@@ -912,95 +1065,271 @@ int main() {
                 player2Ready = true;
             }
 
+            if (autoPlay) {
+                player2Ready = true;
+            }
+
             if (player1Ready && player2Ready) {
                 // 重置游戏
-                player1Score = 0;
-                player2Score = 0;
+                match.player1Score = 0;
+                match.player2Score = 0;
                 gameState = GameState::MainMenu;
                 player1Ready = false;
                 player2Ready = false;
 
-                // 更新分数显示
-                player1ScoreText.setString("0");
-                player2ScoreText.setString("0");
-                stateText.setString("Press WASD or Arrow Keys to Ready");
+                // 分数显示在下一帧随比分更新
+                setStateText("Press WASD or Arrow Keys to Ready");
                 stateText.setPosition({ 240.f, 80.f });
 
-                printf("新游戏开始！\n");
+                logger.info("新游戏开始！");
             }
         }
 
-        // 渲染
-        window.clear(sf::Color::Black);
-
-        // ========== 绘制粒子 ==========
-        for (const auto& particle : particles) {
-            float alpha = particle.lifetime / particle.maxLifetime; // 透明度衰减
-            sf::CircleShape particleShape(particle.size);
-            // 修复：使用标准的 unsigned char 替代 sf::Uint8
-            particleShape.setFillColor(sf::Color(
-                particle.color.r,
-                particle.color.g,
-                particle.color.b,
-                static_cast<unsigned char>(alpha * 255)
-            ));
-            particleShape.setPosition(particle.position);
-            window.draw(particleShape);
+        // 同步模拟状态到精灵（回放时取相邻两份快照插值）
+        const ReplaySnapshot* replayFrame = nullptr;
+        if (gameState == GameState::Replay) {
+            std::size_t index = static_cast<std::size_t>(replayCursor);
+            std::size_t nextIndex = std::min(index + 1, replayBuffer.size() - 1);
+            float t = replayCursor - index;
+            const ReplaySnapshot& a = replayBuffer.at(index);
+            const ReplaySnapshot& b = replayBuffer.at(nextIndex);
+            auto lerp = [t](std::int16_t from, std::int16_t to) {
+                return decodeReplayCoord(from) + (decodeReplayCoord(to) - decodeReplayCoord(from)) * t;
+            };
+            leftPaddle.setPosition({ lerp(a.leftPaddleX, b.leftPaddleX), lerp(a.leftPaddleY, b.leftPaddleY) });
+            rightPaddle.setPosition({ lerp(a.rightPaddleX, b.rightPaddleX), lerp(a.rightPaddleY, b.rightPaddleY) });
+            ball.setPosition({ lerp(a.ballX, b.ballX), lerp(a.ballY, b.ballY) });
+            replayFrame = t < 0.5f ? &a : &b;
+        }
+        else {
+            leftPaddle.setPosition({ pong::toFloat(match.leftPaddle.x), pong::toFloat(match.leftPaddle.y) });
+            rightPaddle.setPosition({ pong::toFloat(match.rightPaddle.x), pong::toFloat(match.rightPaddle.y) });
+            ball.setPosition({ pong::toFloat(match.ball.x), pong::toFloat(match.ball.y) });
         }
 
-        // ========== 绘制游戏对象 ==========
-        // 只在游戏相关状态显示游戏对象
-        if (gameState == GameState::Playing || gameState == GameState::Paused ||
-            gameState == GameState::Waiting || gameState == GameState::Countdown ||
-            gameState == GameState::GameOver || gameState == GameState::Victory) {
+        float tickTime = workClock.getElapsedTime().asSeconds();
+
+        // ========== 脏区跟踪 ==========
+        // 静态状态且没有粒子时，只有可见内容变化才重画并提交一帧
+        int blinkPhase = static_cast<int>(blinkTimer * 2) % 2;
+        SceneKey sceneKey{ gameState, blinkPhase, onePlayerSelected, onePlayerMode, match.player1Score, match.player2Score };
+        bool idle = isStaticState(gameState) && particles.empty() && !musicDirector.isFading();
+        bool needsRedraw = !idle || capturing || sceneDirty || sceneKey != lastSceneKey;
+
+        if (needsRedraw) {
+            // 渲染到离屏纹理（逻辑坐标）
+            sf::RenderTarget& target = sceneTexture;
+            target.clear(sf::Color::Black);
+
+            // ========== 绘制粒子 ==========
+            // 所有粒子拼成一批三角形（与CircleShape相同的圆：左上角在position，半径size），
+            // 顶点从帧内存分配，放不下时分批绘制。回放时画快照里的粒子
+            std::size_t particleCount = replayFrame ? replayFrame->particleCount : particles.size();
+            std::size_t particlePointCount = particleGovernor.pointCount();
+            std::size_t verticesPerParticle = particlePointCount * 3;
+            std::size_t batchCapacity = 0;
+            sf::Vector2f* unitCircle = frameArena.allocateArray<sf::Vector2f>(particlePointCount);
+            sf::Vertex* particleVertices = nullptr;
+            if (unitCircle && particleCount > 0) {
+                for (std::size_t i = 0; i < particlePointCount; ++i) {
+                    float angle = i * 2.f * 3.14159265f / particlePointCount - 3.14159265f / 2.f;
+                    unitCircle[i] = { std::cos(angle), std::sin(angle) };
+                }
+                batchCapacity = std::min(particleCount, frameArena.remainingFor<sf::Vertex>() / verticesPerParticle);
+                if (batchCapacity > 0) {
+                    particleVertices = frameArena.allocateArray<sf::Vertex>(batchCapacity * verticesPerParticle);
+                }
+            }
+            std::size_t batchCount = 0;
+            for (std::size_t p = 0; p < particleCount && particleVertices; ++p) {
+                sf::Vector2f position;
+                float size = 0.0f;
+                sf::Color color;
+                if (replayFrame) {
+                    const ReplayParticle& particle = replayFrame->particles[p];
+                    position = { decodeReplayCoord(particle.x), decodeReplayCoord(particle.y) };
+                    size = particle.size;
+                    color = sf::Color(particle.r, particle.g, particle.b, particle.a);
+                }
+                else {
+                    const Particle& particle = particles[p];
+                    float alpha = particle.lifetime / particle.maxLifetime; // 透明度衰减
+                    position = particle.position;
+                    size = particle.size;
+                    color = sf::Color(particle.color.r, particle.color.g, particle.color.b, static_cast<unsigned char>(alpha * 255));
+                }
+                sf::Vector2f center = position + sf::Vector2f(size, size);
+                sf::Vertex* vertex = particleVertices + batchCount * verticesPerParticle;
+                for (std::size_t i = 0; i < particlePointCount; ++i) {
+                    std::size_t next = (i + 1) % particlePointCount;
+                    *vertex++ = { center, color };
+                    *vertex++ = { center + unitCircle[i] * size, color };
+                    *vertex++ = { center + unitCircle[next] * size, color };
+                }
+                if (++batchCount == batchCapacity || p + 1 == particleCount) {
+                    target.draw(particleVertices, batchCount * verticesPerParticle, sf::PrimitiveType::Triangles);
+                    batchCount = 0;
+                }
+            }
+
+            // ========== 绘制游戏对象 ==========
+            // 只在游戏相关状态显示游戏对象
+            if (gameState == GameState::Playing || gameState == GameState::Paused ||
+                gameState == GameState::Waiting || gameState == GameState::Countdown ||
+                gameState == GameState::GameOver || gameState == GameState::Victory ||
+                gameState == GameState::Replay) {
+
+                if (gameState == GameState::Playing || gameState == GameState::Paused || gameState == GameState::Replay) {
+                    target.draw(leftPaddle);
+                    target.draw(rightPaddle);
+                    target.draw(ball);
+                }
+                else {
+                    ball.setPosition({ 395.f, 295.f });
+                    target.draw(leftPaddle);
+                    target.draw(rightPaddle);
+                    target.draw(ball);
+                }
+            }
 
-            if (gameState == GameState::Playing || gameState == GameState::Paused) {
-                window.draw(leftPaddle);
-                window.draw(rightPaddle);
-                window.draw(ball);
+            // ========== 绘制文本 ==========
+            if (gameState == GameState::MainMenu) {
+                target.draw(menuBackground);
+                // 主菜单时只显示菜单文本，不显示游戏相关文本
+                textBatch.add(titleText);
+                textBatch.add(onePlayerText);
+                textBatch.add(twoPlayersText);
             }
             else {
-                ball.setPosition({ 395.f, 295.f });
-                window.draw(leftPaddle);
-                window.draw(rightPaddle);
-                window.draw(ball);
+                if (gameState == GameState::Paused) {
+                    target.draw(overlay);
+                    textBatch.add(pauseText1);
+                    textBatch.add(pauseText2);
+                }
+                textBatch.add(player1ScoreText);
+                textBatch.add(separatorText);
+                textBatch.add(player2ScoreText);
+
+                if (gameState == GameState::Victory) {
+                    textBatch.add(victoryLine1);
+                    textBatch.add(victoryLine2);
+                }
+                else {
+                    textBatch.add(stateText);
+                }
+            }
+            // 文本都在其他图形之上，一次绘制
+            textBatch.draw(target);
+            // ==============================
+
+            sceneTexture.display();
+
+            // ========== 录制 ==========
+            if (capturing) {
+                captureTimer += deltaTime;
+                if (captureTimer >= 1.0f / CAPTURE_FPS) {
+                    captureTimer = std::min(captureTimer - 1.0f / CAPTURE_FPS, 1.0f / CAPTURE_FPS);
+                    // 读回像素后立即交给编码线程；环形缓冲区满时丢帧（丢帧不计入 --capture-frames，退出时单独报告）。
+                    // copyToImage 每次都分配一张整帧 sf::Image，录制帧不是零分配的
+                    sf::Image frame = sceneTexture.getTexture().copyToImage();
+                    if (frameCapture.submit(frame.getPixelsPtr())) {
+                        ++capturedFrames;
+                    }
+                }
             }
-        }
 
-        // ========== 绘制文本 ==========
-        if (gameState == GameState::MainMenu) {
-            window.draw(menuBackground);
-            // 主菜单时只显示菜单文本，不显示游戏相关文本
-            window.draw(titleText);
-            window.draw(onePlayerText);
-            window.draw(twoPlayersText);
-        }
-        else {
-            if (gameState == GameState::Paused) {
-                window.draw(overlay);
-                window.draw(pauseText1);
-                window.draw(pauseText2);
+            // ========== 呈现：等比放大到窗口 ==========
+            if (!headless) {
+                sf::FloatRect screenRect = letterboxRect(window.getSize());
+                sf::Sprite scene(sceneTexture.getTexture());
+                scene.setPosition(screenRect.position);
+                scene.setScale({ screenRect.size.x / sceneSize.x, screenRect.size.y / sceneSize.y });
+                window.clear(sf::Color::Black);
+                window.draw(scene);
             }
-            window.draw(player1ScoreText);
-            window.draw(separatorText);
-            window.draw(player2ScoreText);
 
-            if (gameState == GameState::Victory) {
-                window.draw(victoryLine1);
-                window.draw(victoryLine2);
+            if (!headless) {
+                window.display();
             }
-            else {
-                window.draw(stateText);
+
+            // 本帧耗时反馈给粒子调节器：GPU受限时渲染开销大多在 display() 的交换里才体现出来
+            particleGovernor.update(workClock.getElapsedTime().asSeconds(), tickTime);
+
+            // 限帧：与 setFramerateLimit 相同的做法，只是睡眠放在计时之后
+            if (!headless) {
+                sf::sleep(sf::seconds(1.0f / FRAME_RATE_LIMIT) - frameLimitClock.getElapsedTime());
+                frameLimitClock.restart();
             }
-        }
-        // ==============================
 
-        window.display();
+            lastSceneKey = sceneKey;
+            sceneDirty = false;
+        }
 
         if (gameState == GameState::Countdown) {
             player1Ready = false;
             player2Ready = false;
         }
+
+        // 压力测试：每秒报告一次
+        if (stressParticles) {
+            ++stressFrames;
+            stressReportTimer += deltaTime;
+            if (stressReportTimer >= 1.0f) {
+                logger.info("压力测试: %.0f FPS, 粒子 %zu, 细节等级 %.2f, 帧耗时 %.2f ms, 逻辑耗时 %.2f ms",
+                    stressFrames / stressReportTimer, particles.size(), particleGovernor.level,
+                    particleGovernor.averageFrameTime * 1000.0f, particleGovernor.averageTickTime * 1000.0f);
+                stressFrames = 0;
+                stressReportTimer = 0.0f;
+            }
+        }
+
+        // 分配检查：整帧都处在Playing状态且已热身，不应有任何堆分配
+        if (allocCheck && frameStartState == GameState::Playing && gameState == GameState::Playing) {
+            std::uint64_t frameAllocations = alloc_tracker::allocationCount() - frameStartAllocations;
+            if (++playingFrames > ALLOC_WARMUP_FRAMES && frameAllocations > 0) {
+                if (++allocatingFrames <= 10) {
+                    logger.warn("分配检查: Playing帧中发生了 %llu 次堆分配", static_cast<unsigned long long>(frameAllocations));
+                }
+            }
+        }
+
+        // 录够帧数后退出
+        if (captureFrameLimit > 0 && capturedFrames >= captureFrameLimit) {
+            window.close();
+        }
+        if (headless && allocCheck && playingFrames >= ALLOC_WARMUP_FRAMES + ALLOC_CHECK_FRAMES) {
+            window.close();
+        }
+
+        // 空闲时阻塞等待事件，最多等到下一次闪烁切换
+        if (idle && !capturing && window.isOpen()) {
+            float timeToBlink = BLINK_INTERVAL - std::fmod(blinkTimer, BLINK_INTERVAL) + 0.001f;
+            pendingEvent = window.waitEvent(sf::seconds(timeToBlink));
+            // 等待的时间只计入闪烁，不计入下一帧的游戏步长
+            blinkTimer += frameClock.restart().asSeconds();
+        }
+    }
+
+    if (capturing) {
+        frameCapture.close();
+        logger.info("录制结束: 写入 %llu 帧, 丢弃 %llu 帧",
+            static_cast<unsigned long long>(frameCapture.framesWritten()),
+            static_cast<unsigned long long>(frameCapture.framesDropped()));
+    }
+    if (telemetryRecorder) {
+        telemetryRecorder->flush();
+        telemetryStream.close();
+        logger.info("遥测结束: 丢弃 %llu 条事件", static_cast<unsigned long long>(telemetryRecorder->droppedEvents()));
+    }
+    if (logger.droppedRecords() > 0) {
+        logger.warn("日志队列满，丢弃 %llu 条记录", static_cast<unsigned long long>(logger.droppedRecords()));
+    }
+    if (allocCheck) {
+        logger.info("分配检查: 热身后 %d 帧Playing中有 %lld 帧分配内存, 帧内存峰值 %zu 字节",
+            std::max(0, playingFrames - ALLOC_WARMUP_FRAMES), allocatingFrames, frameArena.peakBytes());
+        if (allocatingFrames > 0) {
+            return 1;
+        }
     }
     return 0;
 }
\ No newline at end of file
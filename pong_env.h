@@ -0,0 +1,291 @@
+﻿#pragma once
+// ========== 强化学习批量环境 ==========
+// Gym风格的 reset/step，一次推进一批无头对局。观测、奖励、结束标志直接写进调用方提供的
+// 连续缓冲区（可以是共享内存或numpy数组），环境内部不做拷贝、不分配内存。
+// 各环境按分片在工作线程上并行推进，支持跳帧和结束后自动重置。
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "pong_sim.h"
+
+namespace pong {
+
+// 离散动作（自对弈时第二个智能体的左右已镜像，两边语义一致）
+enum EnvAction : std::int32_t {
+    ActionNone = 0,
+    ActionUp = 1,
+    ActionDown = 2,
+    ActionBack = 3,     // 远离中线
+    ActionForward = 4,  // 靠近中线
+    ENV_ACTION_COUNT = 5
+};
+
+// 结束标志
+enum EnvDone : std::uint8_t {
+    EnvRunning = 0,
+    EnvTerminated = 1,  // 一方达到获胜分数
+    EnvTruncated = 2    // 超过单局步数上限
+};
+
+struct EnvConfig {
+    int frameSkip = 4;                    // 每次step重复同一动作的物理步数
+    float tick = 1.0f / 240.0f;           // 物理步长
+    bool selfPlay = false;                // true: 每个环境两个智能体；false: 智能体控制左球拍对内置AI
+    long long maxEpisodeSteps = 100000;   // 每局最多step次数（截断）
+    std::uint32_t seed = 1;               // 第i个环境的发球随机种子为 seed + i
+};
+
+// 观测：8个float，坐标除以场地尺寸，速度除以 VELOCITY_SCALE。
+// 自对弈时第二个智能体的观测左右镜像，自己总在左边。
+// [0] 球x [1] 球y [2] 球vx [3] 球vy [4] 己方球拍x [5] 己方球拍y [6] 对方球拍x [7] 对方球拍y
+constexpr int ENV_OBSERVATION_SIZE = 8;
+
+template <typename Num = float, typename Rules = ClassicRules>
+class VectorEnv {
+public:
+    static constexpr float VELOCITY_SCALE = 1000.0f;
+
+    // threadCount为0时使用全部硬件线程
+    explicit VectorEnv(int envCount, const EnvConfig& config = {}, int threadCount = 0)
+        : config(config), envs(static_cast<std::size_t>(envCount)) {
+        if (threadCount <= 0) {
+            threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        shardCount = std::max(1, std::min(threadCount, envCount));
+        for (int i = 0; i < envCount; ++i) {
+            envs[i].match.rngState = config.seed + static_cast<std::uint32_t>(i);
+        }
+        // 调用线程自己跑第0片，其余各一个工作线程；
+        // 中途创建线程失败时先停掉已启动的线程再抛出，否则析构仍可join的线程会直接terminate
+        try {
+            for (int shard = 1; shard < shardCount; ++shard) {
+                workers.emplace_back(&VectorEnv::workerLoop, this, shard);
+            }
+        }
+        catch (...) {
+            stopWorkers();
+            throw;
+        }
+    }
+    VectorEnv(const VectorEnv&) = delete;
+    VectorEnv& operator=(const VectorEnv&) = delete;
+
+    ~VectorEnv() { stopWorkers(); }
+
+    int envCount() const { return static_cast<int>(envs.size()); }
+    int agentsPerEnv() const { return config.selfPlay ? 2 : 1; }
+    int threadCount() const { return shardCount; }
+
+    // 重置全部环境。observations: envCount * agentsPerEnv * ENV_OBSERVATION_SIZE
+    void reset(float* observations) {
+        job = { nullptr, observations, nullptr, nullptr };
+        resetting = true;
+        runJob();
+    }
+
+    // actions:      envCount * agentsPerEnv
+    // rewards:      envCount * agentsPerEnv（得分+1，失分-1，跳帧内累加）
+    // dones:        envCount（EnvDone）；结束的环境已自动重置，observations是新一局的初始观测
+    void step(const std::int32_t* actions, float* observations, float* rewards, std::uint8_t* dones) {
+        job = { actions, observations, rewards, dones };
+        resetting = false;
+        runJob();
+    }
+
+private:
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            stopping = true;
+            generation.fetch_add(1, std::memory_order_release);
+        }
+        jobReady.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+    struct Job {
+        const std::int32_t* actions;
+        float* observations;
+        float* rewards;
+        std::uint8_t* dones;
+    };
+
+    // 每个环境独占缓存行，避免相邻线程互相失效
+    struct alignas(64) EnvSlot {
+        BasicMatchState<Num> match;
+        long long episodeSteps = 0;
+    };
+
+    // ========== 单个环境 ==========
+    void resetEnv(EnvSlot& env) {
+        std::uint32_t rng = env.match.rngState;
+        env.match = BasicMatchState<Num>();
+        env.match.rngState = rng;
+        env.episodeSteps = 0;
+        serveBall<Rules>(env.match);
+    }
+
+    static PaddleInput toInput(std::int32_t action, bool mirrored) {
+        PaddleInput input;
+        input.up = action == ActionUp;
+        input.down = action == ActionDown;
+        bool back = action == ActionBack;
+        bool forward = action == ActionForward;
+        // 左球拍后退是向左，右球拍后退是向右
+        input.left = mirrored ? forward : back;
+        input.right = mirrored ? back : forward;
+        return input;
+    }
+
+    void writeObservation(const BasicMatchState<Num>& match, bool mirrored, float* out) const {
+        const float width = Rules::fieldWidth;
+        const float height = Rules::fieldHeight;
+        auto mirrorX = [&](float x, float size) { return mirrored ? width - x - size : x; };
+        const Vec2<Num>& own = mirrored ? match.rightPaddle : match.leftPaddle;
+        const Vec2<Num>& other = mirrored ? match.leftPaddle : match.rightPaddle;
+        float velocityX = toFloat(match.ballVelocity.x);
+        out[0] = mirrorX(toFloat(match.ball.x), Rules::ballSize) / width;
+        out[1] = toFloat(match.ball.y) / height;
+        out[2] = (mirrored ? -velocityX : velocityX) / VELOCITY_SCALE;
+        out[3] = toFloat(match.ballVelocity.y) / VELOCITY_SCALE;
+        out[4] = mirrorX(toFloat(own.x), Rules::paddleWidth) / width;
+        out[5] = toFloat(own.y) / height;
+        out[6] = mirrorX(toFloat(other.x), Rules::paddleWidth) / width;
+        out[7] = toFloat(other.y) / height;
+    }
+
+    void writeObservations(const EnvSlot& env, std::size_t index, float* observations) const {
+        int agents = agentsPerEnv();
+        for (int agent = 0; agent < agents; ++agent) {
+            writeObservation(env.match, agent == 1, observations + (index * agents + agent) * ENV_OBSERVATION_SIZE);
+        }
+    }
+
+    template <PlayerMode Mode>
+    void stepEnv(EnvSlot& env, std::size_t index) {
+        constexpr int agents = Mode == PlayerMode::TwoPlayers ? 2 : 1;
+        PaddleInput player1 = toInput(job.actions[index * agents], false);
+        PaddleInput player2;
+        if constexpr (Mode == PlayerMode::TwoPlayers) {
+            player2 = toInput(job.actions[index * agents + 1], true);
+        }
+
+        const Num tick = Num(config.tick);
+        NullHooks hooks;
+        float reward = 0.0f;  // 以玩家1视角
+        std::uint8_t done = EnvRunning;
+        for (int frame = 0; frame < config.frameSkip; ++frame) {
+            int scorer = stepPlaying<Mode, Rules>(env.match, player1, player2, tick, hooks);
+            if (scorer != 0) {
+                reward += scorer == 1 ? 1.0f : -1.0f;
+                if (env.match.player1Score >= Rules::winningScore || env.match.player2Score >= Rules::winningScore) {
+                    done = EnvTerminated;
+                }
+                else {
+                    serveBall<Rules>(env.match);
+                }
+                break;  // 得分后不再重复动作，让智能体看到新的发球
+            }
+        }
+        if (done == EnvRunning && ++env.episodeSteps >= config.maxEpisodeSteps) {
+            done = EnvTruncated;
+        }
+
+        job.rewards[index * agents] = reward;
+        if constexpr (agents == 2) {
+            job.rewards[index * agents + 1] = -reward;
+        }
+        job.dones[index] = done;
+        if (done != EnvRunning) {
+            resetEnv(env);
+        }
+        writeObservations(env, index, job.observations);
+    }
+
+    void runShard(int shard) {
+        std::size_t begin = envs.size() * shard / shardCount;
+        std::size_t end = envs.size() * (shard + 1) / shardCount;
+        for (std::size_t i = begin; i < end; ++i) {
+            if (resetting) {
+                resetEnv(envs[i]);
+                writeObservations(envs[i], i, job.observations);
+            }
+            else if (config.selfPlay) {
+                stepEnv<PlayerMode::TwoPlayers>(envs[i], i);
+            }
+            else {
+                stepEnv<PlayerMode::OnePlayer>(envs[i], i);
+            }
+        }
+    }
+
+    // ========== 线程调度 ==========
+    // step通常只有几微秒，先自旋等待再睡眠，避免每步都付出条件变量唤醒的延迟
+    static constexpr int SPIN_ITERATIONS = 20000;
+
+    void runJob() {
+        if (shardCount > 1) {
+            remaining.store(shardCount - 1, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(jobMutex);
+                generation.fetch_add(1, std::memory_order_release);
+            }
+            jobReady.notify_all();
+        }
+        runShard(0);
+        if (shardCount > 1) {
+            for (int spin = 0; spin < SPIN_ITERATIONS; ++spin) {
+                if (remaining.load(std::memory_order_acquire) == 0) {
+                    return;
+                }
+            }
+            std::unique_lock<std::mutex> lock(doneMutex);
+            jobDone.wait(lock, [&] { return remaining.load(std::memory_order_acquire) == 0; });
+        }
+    }
+
+    void workerLoop(int shard) {
+        std::uint64_t seen = 0;
+        for (;;) {
+            bool ready = false;
+            for (int spin = 0; spin < SPIN_ITERATIONS && !ready; ++spin) {
+                ready = generation.load(std::memory_order_acquire) != seen;
+            }
+            if (!ready) {
+                std::unique_lock<std::mutex> lock(jobMutex);
+                jobReady.wait(lock, [&] { return generation.load(std::memory_order_acquire) != seen; });
+            }
+            seen = generation.load(std::memory_order_acquire);
+            if (stopping) {
+                return;
+            }
+            runShard(shard);
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                jobDone.notify_one();
+            }
+        }
+    }
+
+    EnvConfig config;
+    std::vector<EnvSlot> envs;
+    Job job{};
+    bool resetting = false;
+
+    int shardCount = 1;
+    std::vector<std::thread> workers;
+    std::atomic<std::uint64_t> generation{ 0 };
+    std::atomic<int> remaining{ 0 };
+    bool stopping = false;
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::mutex doneMutex;
+    std::condition_variable jobDone;
+};
+
+} // namespace pong
@@ -0,0 +1,100 @@
+﻿#pragma once
+// ========== Q16.16 定点数 ==========
+// 只用整数运算，不同编译器、优化选项、SIMD宽度下结果逐位一致，
+// 用于锁步联机和跨机器回放。三角函数查表，表在编译期生成。
+#include <array>
+#include <cstdint>
+
+namespace pong {
+
+struct Fixed {
+    static constexpr int FRACTION_BITS = 16;
+    static constexpr std::int32_t ONE = 1 << FRACTION_BITS;
+
+    std::int32_t raw = 0;
+
+    constexpr Fixed() = default;
+    constexpr explicit Fixed(int value) : raw(value * ONE) {}
+    // 浮点常量只在转换时用一次（乘2的幂是精确的，再四舍五入）
+    constexpr explicit Fixed(float value)
+        : raw(static_cast<std::int32_t>(value * ONE + (value >= 0.f ? 0.5f : -0.5f))) {}
+
+    static constexpr Fixed fromRaw(std::int32_t value) {
+        Fixed result;
+        result.raw = value;
+        return result;
+    }
+
+    constexpr float toFloat() const { return static_cast<float>(raw) / ONE; }
+    // 向下取整
+    constexpr int toInt() const { return raw >> FRACTION_BITS; }
+
+    constexpr Fixed operator-() const { return fromRaw(-raw); }
+    constexpr Fixed operator+(Fixed other) const { return fromRaw(raw + other.raw); }
+    constexpr Fixed operator-(Fixed other) const { return fromRaw(raw - other.raw); }
+    // 乘法用64位中间值并四舍五入
+    constexpr Fixed operator*(Fixed other) const {
+        return fromRaw(static_cast<std::int32_t>((static_cast<std::int64_t>(raw) * other.raw + (ONE / 2)) >> FRACTION_BITS));
+    }
+    constexpr Fixed operator/(Fixed other) const {
+        return fromRaw(static_cast<std::int32_t>(static_cast<std::int64_t>(raw) * ONE / other.raw));
+    }
+
+    constexpr Fixed& operator+=(Fixed other) { raw += other.raw; return *this; }
+    constexpr Fixed& operator-=(Fixed other) { raw -= other.raw; return *this; }
+    constexpr Fixed& operator*=(Fixed other) { return *this = *this * other; }
+
+    constexpr bool operator==(Fixed other) const { return raw == other.raw; }
+    constexpr bool operator!=(Fixed other) const { return raw != other.raw; }
+    constexpr bool operator<(Fixed other) const { return raw < other.raw; }
+    constexpr bool operator>(Fixed other) const { return raw > other.raw; }
+    constexpr bool operator<=(Fixed other) const { return raw <= other.raw; }
+    constexpr bool operator>=(Fixed other) const { return raw >= other.raw; }
+};
+
+constexpr Fixed absOf(Fixed value) { return value.raw < 0 ? -value : value; }
+
+namespace detail {
+
+// 编译期泰勒展开（double常量求值按IEEE规则进行，结果固定）
+constexpr double taylorSin(double x) {
+    const double pi = 3.14159265358979323846;
+    while (x > pi) x -= 2 * pi;
+    while (x < -pi) x += 2 * pi;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 20; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr std::int32_t toFixedRaw(double value) {
+    return static_cast<std::int32_t>(value * Fixed::ONE + (value >= 0 ? 0.5 : -0.5));
+}
+
+// 角度以0.01弧度为单位，与发球的 rand() % 628 对应
+constexpr int TRIG_TABLE_SIZE = 628;
+
+template <bool Cosine>
+constexpr std::array<std::int32_t, TRIG_TABLE_SIZE> makeTrigTable() {
+    const double halfPi = 1.57079632679489661923;
+    std::array<std::int32_t, TRIG_TABLE_SIZE> table{};
+    for (int i = 0; i < TRIG_TABLE_SIZE; ++i) {
+        double angle = i / 100.0;
+        table[i] = toFixedRaw(taylorSin(Cosine ? angle + halfPi : angle));
+    }
+    return table;
+}
+
+inline constexpr std::array<std::int32_t, TRIG_TABLE_SIZE> SIN_TABLE = makeTrigTable<false>();
+inline constexpr std::array<std::int32_t, TRIG_TABLE_SIZE> COS_TABLE = makeTrigTable<true>();
+
+} // namespace detail
+
+// centiRadians: 0 ~ 627，即 0 ~ 6.27 弧度
+constexpr Fixed fixedSinCenti(int centiRadians) { return Fixed::fromRaw(detail::SIN_TABLE[centiRadians]); }
+constexpr Fixed fixedCosCenti(int centiRadians) { return Fixed::fromRaw(detail::COS_TABLE[centiRadians]); }
+
+} // namespace pong
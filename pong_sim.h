@@ -0,0 +1,430 @@
+﻿#pragma once
+// ========== 对局模拟核心 ==========
+// 不依赖SFML：游戏本体、无头批量模拟和工具共用同一份物理逻辑
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include "pong_fixed.h"
+
+namespace pong {
+
+// 玩家模式（编译期参数）
+enum class PlayerMode {
+    OnePlayer,  // 玩家 vs AI
+    TwoPlayers  // 玩家 vs 玩家
+};
+
+template <typename T>
+struct Vec2 {
+    T x{};
+    T y{};
+};
+
+// ========== 标量运算 ==========
+// 物理代码对标量类型泛型：float（默认）或 Fixed（逐位确定的定点数）
+template <typename Num>
+constexpr Num num(float value) { return Num(value); }
+
+template <typename Num>
+constexpr Vec2<Num> vec(Vec2<float> value) { return { Num(value.x), Num(value.y) }; }
+
+inline float absOf(float value) { return std::abs(value); }
+
+inline float toFloat(float value) { return value; }
+inline float toFloat(Fixed value) { return value.toFloat(); }
+
+inline int toInt(float value) { return static_cast<int>(value); }
+inline int toInt(Fixed value) { return value.toInt(); }
+
+// 以0.01弧度为单位的三角函数：float走<cmath>，定点数查表
+template <typename Num>
+Num cosCenti(int centiRadians) {
+    if constexpr (std::is_same_v<Num, Fixed>) {
+        return fixedCosCenti(centiRadians);
+    }
+    else {
+        return std::cos(centiRadians / 100.0f);
+    }
+}
+
+template <typename Num>
+Num sinCenti(int centiRadians) {
+    if constexpr (std::is_same_v<Num, Fixed>) {
+        return fixedSinCenti(centiRadians);
+    }
+    else {
+        return std::sin(centiRadians / 100.0f);
+    }
+}
+
+// ========== 规则表：所有物理常量集中在这里 ==========
+struct ClassicRules {
+    // 场地
+    static constexpr float fieldWidth = 800.f;
+    static constexpr float fieldHeight = 600.f;
+    static constexpr float centerLineX = 400.f;   // 球拍不能越过中线
+
+    // 物体尺寸
+    static constexpr float paddleWidth = 25.f;
+    static constexpr float paddleHeight = 120.f;
+    static constexpr float ballSize = 25.f;
+
+    // 初始位置
+    static constexpr Vec2<float> leftPaddleStart{ 50.f, 250.f };
+    static constexpr Vec2<float> rightPaddleStart{ 730.f, 250.f };
+    static constexpr Vec2<float> ballServePosition{ 395.f, 295.f };
+
+    // 速度（像素/秒）
+    static constexpr float paddleSpeed = 700.f;
+    static constexpr float aiSpeed = 600.f;
+    static constexpr float serveSpeed = 500.f;
+    static constexpr float aiDecisionInterval = 0.25f;
+
+    // 质量定义
+    static constexpr float paddleMass = 400.f;  // 球拍质量
+    static constexpr float ballMass = 314.f;    // 球质量
+
+    // 动量定理系数（编译期算好）
+    static constexpr float ballRetain = (ballMass - paddleMass) / (paddleMass + ballMass);
+    static constexpr float paddleTransfer = (2 * paddleMass) / (paddleMass + ballMass);
+
+    // 击球后Y方向速度变化
+    static constexpr float hitSpeedGain = 0.4f;
+    static constexpr float minYSpeed = 100.f;
+    static constexpr float maxYSpeed = 600.f;
+
+    // 上下墙反弹衰减
+    static constexpr float wallDampingY = 0.8f;
+    static constexpr float wallDampingX = 0.9f;
+
+    static constexpr int winningScore = 9;
+};
+
+// 一个球拍在当前帧的按键输入
+struct PaddleInput {
+    bool up = false;
+    bool down = false;
+    bool left = false;
+    bool right = false;
+
+    bool any() const { return up || down || left || right; }
+};
+
+// 一局比赛的全部可模拟状态
+template <typename Num>
+struct BasicMatchState {
+    using Scalar = Num;
+
+    Vec2<Num> leftPaddle = vec<Num>(ClassicRules::leftPaddleStart);
+    Vec2<Num> rightPaddle = vec<Num>(ClassicRules::rightPaddleStart);
+    Vec2<Num> ball = vec<Num>(ClassicRules::ballServePosition);
+    Vec2<Num> ballVelocity{ Num(500.f), Num(300.f) };
+
+    // AI状态
+    Num aiDecisionTimer{};
+    Num aiCurrentDirection1{};  // Y方向
+    Num aiCurrentDirection2{};  // X方向
+
+    int player1Score = 0;
+    int player2Score = 0;
+
+    // 发球用的随机数（与MSVC rand()相同的线性同余，默认种子1）
+    std::uint32_t rngState = 1;
+
+    int nextRandom() {
+        rngState = rngState * 214013u + 2531011u;
+        return static_cast<int>((rngState >> 16) & 0x7fff);
+    }
+};
+
+using MatchState = BasicMatchState<float>;       // 默认浮点物理
+using FixedMatchState = BasicMatchState<Fixed>;  // 确定性定点物理
+
+// 无渲染、无音效的钩子：无头批量模拟使用
+// （钩子只做表现，坐标始终以float传入）
+struct NullHooks {
+    void onWallBounce() {}
+    void onPaddleHit(int /*player*/, float /*hitRatio*/, Vec2<float> /*incomingVelocity*/) {}
+    void onAiDecision(float /*distance*/) {}
+    void onScore(int /*player*/, Vec2<float> /*ballPosition*/) {}
+};
+
+// 把球放回中间并以随机角度发球
+template <typename Rules = ClassicRules, typename Num>
+void serveBall(BasicMatchState<Num>& match) {
+    match.ball = vec<Num>(Rules::ballServePosition);
+
+    // 随机角度（0 到 2π，单位0.01弧度）
+    int angle = match.nextRandom() % 628;
+    while (absOf(cosCenti<Num>(angle)) < num<Num>(0.3f) || absOf(cosCenti<Num>(angle)) > num<Num>(0.9f)) {
+        angle = match.nextRandom() % 628;
+    }
+
+    match.ballVelocity.x = cosCenti<Num>(angle) * num<Num>(Rules::serveSpeed);
+    match.ballVelocity.y = sinCenti<Num>(angle) * num<Num>(Rules::serveSpeed);
+}
+
+// 得分后球拍回到初始位置
+template <typename Rules = ClassicRules, typename Num>
+void resetPaddles(BasicMatchState<Num>& match) {
+    match.leftPaddle = vec<Num>(Rules::leftPaddleStart);
+    match.rightPaddle = vec<Num>(Rules::rightPaddleStart);
+}
+
+namespace detail {
+
+// 与 sf::Rect::findIntersection 一致：只有重叠面积大于0才算碰撞
+template <typename Num>
+bool overlaps(Vec2<Num> a, Vec2<Num> aSize, Vec2<Num> b, Vec2<Num> bSize) {
+    return std::max(a.x, b.x) < std::min(a.x + aSize.x, b.x + bSize.x) &&
+           std::max(a.y, b.y) < std::min(a.y + aSize.y, b.y + bSize.y);
+}
+
+// 玩家控制的球拍，按键顺序和边界修正与原先逐键处理一致
+template <typename Rules, typename Num>
+void movePlayerPaddle(Vec2<Num>& paddle, const PaddleInput& input, Num minX, Num maxX, Num dt) {
+    const Num step = num<Num>(Rules::paddleSpeed) * dt;
+    const Num maxY = num<Num>(Rules::fieldHeight - Rules::paddleHeight);
+    if (input.up) {
+        paddle.y += -step;
+        if (paddle.y < Num{}) {
+            paddle.y = Num{};
+        }
+    }
+    if (input.down) {
+        paddle.y += step;
+        if (paddle.y + num<Num>(Rules::paddleHeight) > num<Num>(Rules::fieldHeight)) {
+            paddle.y = maxY;
+        }
+    }
+    if (input.left) {
+        paddle.x += -step;
+        if (paddle.x < minX) {
+            paddle.x = minX;
+        }
+    }
+    if (input.right) {
+        paddle.x += step;
+        if (paddle.x + num<Num>(Rules::paddleWidth) > maxX) {
+            paddle.x = maxX - num<Num>(Rules::paddleWidth);
+        }
+    }
+}
+
+// 每0.25秒检测的AI控制系统
+template <typename Rules, typename Num, typename Hooks>
+void moveAiPaddle(BasicMatchState<Num>& match, Num dt, Hooks& hooks) {
+    match.aiDecisionTimer -= dt;
+
+    if (match.aiDecisionTimer <= Num{}) {
+        Num ballCenterY = match.ball.y + num<Num>(Rules::ballSize / 2);
+        Num paddleCenterY = match.rightPaddle.y + num<Num>(Rules::paddleHeight / 2);
+
+        // 计算目标方向：距离越远，移动越快
+        Num distance = ballCenterY - paddleCenterY;
+        hooks.onAiDecision(toFloat(distance));
+        if (absOf(distance) > num<Num>(50.0f)) {
+            match.aiCurrentDirection1 = num<Num>((distance > Num{}) ? 1.0f : -1.0f);
+        }
+        else {
+            match.aiCurrentDirection1 = num<Num>((distance > Num{}) ? 0.6f : -0.6f);
+        }
+        if (match.ball.x > num<Num>(Rules::centerLineX)) {
+            match.aiCurrentDirection2 = num<Num>((match.ballVelocity.x > Num{}) ? -1.0f : 0.5f);
+        }
+        else {
+            match.aiCurrentDirection2 = num<Num>((match.ballVelocity.x > Num{}) ? -0.6f : 0.3f);
+        }
+        if (match.rightPaddle.x < match.ball.x) {
+            match.aiCurrentDirection2 = num<Num>(1.5f);
+        }
+        match.aiDecisionTimer = num<Num>(Rules::aiDecisionInterval);
+    }
+
+    // 持续应用移动（保持平滑）
+    Vec2<Num>& paddle = match.rightPaddle;
+    paddle.y += match.aiCurrentDirection1 * num<Num>(Rules::aiSpeed) * dt;
+    paddle.x += match.aiCurrentDirection2 * num<Num>(Rules::aiSpeed) * dt;
+
+    // AI边界检测，碰到上下边界时停止
+    if (paddle.y < Num{}) {
+        paddle.y = Num{};
+        match.aiCurrentDirection1 = Num{};
+    }
+    if (paddle.y + num<Num>(Rules::paddleHeight) > num<Num>(Rules::fieldHeight)) {
+        paddle.y = num<Num>(Rules::fieldHeight - Rules::paddleHeight);
+        match.aiCurrentDirection1 = Num{};
+    }
+    if (paddle.x < num<Num>(Rules::centerLineX)) {
+        paddle.x = num<Num>(Rules::centerLineX);
+    }
+    if (paddle.x + num<Num>(Rules::paddleWidth) > num<Num>(Rules::fieldWidth)) {
+        paddle.x = num<Num>(Rules::fieldWidth - Rules::paddleWidth);
+    }
+}
+
+// 球拍击球：X方向动量定理，Y方向按击中位置变化，返回击中位置比例（0=上沿，1=下沿）
+template <typename Rules, typename Num>
+Num applyPaddleHit(BasicMatchState<Num>& match, const Vec2<Num>& paddle, Num paddleVelocityX) {
+    Vec2<Num>& velocity = match.ballVelocity;
+    velocity.x = num<Num>(Rules::ballRetain) * velocity.x + num<Num>(Rules::paddleTransfer) * paddleVelocityX;
+
+    Num ballCenterY = match.ball.y + num<Num>(Rules::ballSize / 2);
+    Num hitRatio = (ballCenterY - paddle.y) / num<Num>(Rules::paddleHeight);
+    hitRatio = std::clamp(hitRatio, Num{}, num<Num>(1.0f));
+    Num hitPosition = hitRatio - num<Num>(0.5f);
+
+    // 统一的速度变化系数公式（保持原方向）
+    Num speedChangeFactor = num<Num>(4.0f) * absOf(hitPosition) - num<Num>(1.0f);
+    Num baseSpeedChange = absOf(velocity.y) * num<Num>(Rules::hitSpeedGain);
+    if (velocity.y >= Num{}) {
+        velocity.y += speedChangeFactor * baseSpeedChange;
+    }
+    else {
+        velocity.y -= speedChangeFactor * baseSpeedChange;
+    }
+
+    // 速度限制
+    const Num minYSpeed = num<Num>(Rules::minYSpeed);
+    const Num maxYSpeed = num<Num>(Rules::maxYSpeed);
+    if (absOf(velocity.y) > maxYSpeed) {
+        velocity.y = (velocity.y > Num{}) ? maxYSpeed : -maxYSpeed;
+    }
+    if (absOf(velocity.y) < minYSpeed) {
+        velocity.y = (velocity.y > Num{}) ? minYSpeed : -minYSpeed;
+    }
+    return hitRatio;
+}
+
+template <typename Num>
+Num paddleVelocityX(const PaddleInput& input, Num speed) {
+    if (input.left) return -speed;
+    if (input.right) return speed;
+    return Num{};
+}
+
+} // namespace detail
+
+// ========== Playing状态的一步模拟 ==========
+// 模式和规则在编译期确定，每个组合各自生成一份没有模式分支的代码；
+// 标量类型由状态决定（float 或 Fixed）。
+// 返回得分的玩家（1或2），没有得分返回0。
+template <PlayerMode Mode, typename Rules = ClassicRules, typename Num, typename Hooks>
+int stepPlaying(BasicMatchState<Num>& match, const PaddleInput& player1, const PaddleInput& player2, Num dt, Hooks& hooks) {
+    const Vec2<Num> paddleSize{ num<Num>(Rules::paddleWidth), num<Num>(Rules::paddleHeight) };
+    const Vec2<Num> ballSize{ num<Num>(Rules::ballSize), num<Num>(Rules::ballSize) };
+    const Num centerLineX = num<Num>(Rules::centerLineX);
+
+    // 球拍移动
+    detail::movePlayerPaddle<Rules>(match.leftPaddle, player1, Num{}, centerLineX, dt);
+    if constexpr (Mode == PlayerMode::OnePlayer) {
+        detail::moveAiPaddle<Rules>(match, dt, hooks);
+    }
+    else {
+        detail::movePlayerPaddle<Rules>(match.rightPaddle, player2, centerLineX, num<Num>(Rules::fieldWidth), dt);
+    }
+
+    // 球移动
+    match.ball.x += match.ballVelocity.x * dt;
+    match.ball.y += match.ballVelocity.y * dt;
+
+    // 上下边界碰撞
+    if (match.ball.y <= Num{}) {
+        hooks.onWallBounce();
+        match.ballVelocity.y = absOf(match.ballVelocity.y) * num<Num>(Rules::wallDampingY);  // 确保向下
+        match.ballVelocity.x *= num<Num>(Rules::wallDampingX);
+        match.ball.y = Num{};
+    }
+    else if (match.ball.y + ballSize.y >= num<Num>(Rules::fieldHeight)) {
+        hooks.onWallBounce();
+        match.ballVelocity.y = -absOf(match.ballVelocity.y) * num<Num>(Rules::wallDampingY);  // 确保向上
+        match.ballVelocity.x *= num<Num>(Rules::wallDampingX);
+        match.ball.y = num<Num>(Rules::fieldHeight - Rules::ballSize);
+    }
+
+    // 左右边界 - 得分
+    int scorer = 0;
+    if (match.ball.x <= Num{}) {
+        scorer = 2;
+        match.player2Score++;
+    }
+    else if (match.ball.x + ballSize.x >= num<Num>(Rules::fieldWidth)) {
+        scorer = 1;
+        match.player1Score++;
+    }
+    if (scorer != 0) {
+        hooks.onScore(scorer, Vec2<float>{ toFloat(match.ball.x), toFloat(match.ball.y) });
+        resetPaddles<Rules>(match);
+    }
+
+    // 球拍碰撞检测
+    if (detail::overlaps(match.leftPaddle, paddleSize, match.ball, ballSize)) {
+        Vec2<float> incomingVelocity{ toFloat(match.ballVelocity.x), toFloat(match.ballVelocity.y) };
+        Num hitRatio = detail::applyPaddleHit<Rules>(match, match.leftPaddle, detail::paddleVelocityX(player1, num<Num>(Rules::paddleSpeed)));
+        hooks.onPaddleHit(1, toFloat(hitRatio), incomingVelocity);
+
+        // 确保球向右运动并修正位置
+        match.ballVelocity.x = absOf(match.ballVelocity.x);
+        match.ball.x = match.leftPaddle.x + paddleSize.x + num<Num>(1.f);
+    }
+
+    if (detail::overlaps(match.rightPaddle, paddleSize, match.ball, ballSize)) {
+        Vec2<float> incomingVelocity{ toFloat(match.ballVelocity.x), toFloat(match.ballVelocity.y) };
+        Num rightPaddleVelocityX;
+        if constexpr (Mode == PlayerMode::OnePlayer) {
+            // AI控制的球拍X速度 = AI方向 * AI速度
+            rightPaddleVelocityX = match.aiCurrentDirection2 * num<Num>(Rules::aiSpeed);
+        }
+        else {
+            rightPaddleVelocityX = detail::paddleVelocityX(player2, num<Num>(Rules::paddleSpeed));
+        }
+        Num hitRatio = detail::applyPaddleHit<Rules>(match, match.rightPaddle, rightPaddleVelocityX);
+        hooks.onPaddleHit(2, toFloat(hitRatio), incomingVelocity);
+
+        // 确保球向左运动并修正位置
+        match.ballVelocity.x = -absOf(match.ballVelocity.x);
+        match.ball.x = match.rightPaddle.x - ballSize.x - num<Num>(1.f);
+    }
+
+    return scorer;
+}
+
+// 简单的自动驾驶输入：追踪球的Y坐标，球靠近时向前迎击。
+// 供无头模拟和自动演示使用，player为1（左）或2（右）。
+template <typename Rules = ClassicRules, typename Num>
+PaddleInput autoPilotInput(const BasicMatchState<Num>& match, int player) {
+    const Vec2<Num>& paddle = (player == 1) ? match.leftPaddle : match.rightPaddle;
+    const Vec2<Num> home = vec<Num>((player == 1) ? Rules::leftPaddleStart : Rules::rightPaddleStart);
+    const Num centerLineX = num<Num>(Rules::centerLineX);
+
+    PaddleInput input;
+    bool approaching = (player == 1) ? match.ballVelocity.x < Num{} : match.ballVelocity.x > Num{};
+
+    // 球飞进己方半场时才追踪球，否则回到场地中央。
+    // 瞄准点带一个由球速决定的偏移，模拟打边角和偶尔失误。
+    bool ownHalf = (player == 1) ? match.ball.x < centerLineX : match.ball.x > centerLineX;
+    int aimOffset = toInt(absOf(match.ballVelocity.x) * num<Num>(7.f) + absOf(match.ballVelocity.y) * num<Num>(13.f)) % 150 - 75;
+    Num targetY = (approaching && ownHalf)
+        ? match.ball.y + num<Num>(Rules::ballSize / 2) + Num(static_cast<float>(aimOffset))
+        : num<Num>(Rules::fieldHeight / 2);
+    Num paddleCenterY = paddle.y + num<Num>(Rules::paddleHeight / 2);
+    input.up = targetY < paddleCenterY - num<Num>(10.f);
+    input.down = targetY > paddleCenterY + num<Num>(10.f);
+
+    Num gap = (player == 1) ? match.ball.x - (paddle.x + num<Num>(Rules::paddleWidth))
+                            : paddle.x - (match.ball.x + num<Num>(Rules::ballSize));
+    bool forward = approaching && gap < num<Num>(120.f);
+    bool backward = !forward && absOf(paddle.x - home.x) > num<Num>(5.f);
+    if (player == 1) {
+        input.right = forward;
+        input.left = backward && paddle.x > home.x;
+    }
+    else {
+        input.left = forward;
+        input.right = backward && paddle.x < home.x;
+    }
+    return input;
+}
+
+} // namespace pong
@@ -0,0 +1,73 @@
+﻿#pragma once
+// ========== 即时回放缓冲区 ==========
+// 固定大小的环形缓冲区，保存最近几秒的紧凑快照（球、球拍、最多96个粒子）。
+// 快照是POD，写入只是一次memcpy，启动时一次分配，之后不再分配，可以一直开着。
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// 坐标以1/8像素为单位存成int16（覆盖 -4096 ~ 4095 像素）
+constexpr float REPLAY_COORD_SCALE = 8.0f;
+
+inline std::int16_t encodeReplayCoord(float value) {
+    float scaled = std::round(value * REPLAY_COORD_SCALE);
+    return static_cast<std::int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
+}
+
+inline float decodeReplayCoord(std::int16_t value) { return value / REPLAY_COORD_SCALE; }
+
+struct ReplayParticle {
+    std::int16_t x = 0;
+    std::int16_t y = 0;
+    std::uint8_t r = 0, g = 0, b = 0, a = 0;
+    std::uint8_t size = 0;  // 半径（像素）
+};
+
+struct ReplaySnapshot {
+    static constexpr int MAX_PARTICLES = 96;
+
+    std::int16_t ballX = 0, ballY = 0;
+    std::int16_t leftPaddleX = 0, leftPaddleY = 0;
+    std::int16_t rightPaddleX = 0, rightPaddleY = 0;
+    std::uint16_t particleCount = 0;
+    ReplayParticle particles[MAX_PARTICLES];
+};
+
+static_assert(std::is_trivially_copyable_v<ReplaySnapshot>, "快照必须能直接memcpy");
+
+class ReplayBuffer {
+public:
+    explicit ReplayBuffer(std::size_t capacity) : slots(new ReplaySnapshot[capacity]), capacity(capacity) {}
+    ReplayBuffer(const ReplayBuffer&) = delete;
+    ReplayBuffer& operator=(const ReplayBuffer&) = delete;
+
+    void push(const ReplaySnapshot& snapshot) {
+        std::memcpy(&slots[(start + count) % capacity], &snapshot, sizeof(ReplaySnapshot));
+        if (count < capacity) {
+            ++count;
+        }
+        else {
+            start = (start + 1) % capacity;  // 覆盖最旧的快照
+        }
+    }
+
+    void clear() {
+        start = 0;
+        count = 0;
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // 0 = 最旧，size()-1 = 最新
+    const ReplaySnapshot& at(std::size_t index) const { return slots[(start + index) % capacity]; }
+
+private:
+    std::unique_ptr<ReplaySnapshot[]> slots;
+    std::size_t capacity;
+    std::size_t start = 0;
+    std::size_t count = 0;
+};
@@ -0,0 +1,630 @@
+﻿#pragma once
+// ========== 对局遥测 ==========
+// 记录击球速度、击中位置（hitRatio）、回合长度和AI反应误差，用于平衡性调整。
+//
+// 每个产生事件的线程持有自己的 TelemetryRecorder：事件写进预先分配好的列式块，
+// record() 只写数组，没有分配也没有锁。块写满（或调用 flush）时在调用线程上提交给
+// TelemetryStream：短暂持有队列锁并唤醒后台写线程，每4096个事件才发生一次。
+// 写线程按列压缩写入文件。备用块还没写完、或写线程积压到队列已满时，事件被丢弃并计数。
+//
+// 文件格式（小端）：
+//   "PTLM" u32版本（版本1只用编码1~3，版本2起可能出现编码4、5）
+//   每块: u32事件数, 然后每列: u8编码, u32字节数, 数据
+// 列顺序见 TelemetryColumn，编码见 TelemetryCodec。
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class TelemetryEvent : std::uint8_t {
+    PaddleHit = 1,   // player=击球方, value0=来球速度, value1=hitRatio
+    Score = 2,       // player=得分方, count=回合内击球数
+    AiDecision = 3,  // value0=球与AI球拍中心的Y距离（反应误差）
+    WallBounce = 4
+};
+
+enum TelemetryColumn { COL_TICK, COL_KIND, COL_PLAYER, COL_COUNT, COL_VALUE0, COL_VALUE1, COLUMN_COUNT };
+
+enum class TelemetryCodec : std::uint8_t {
+    DeltaVarint = 1,  // 整数：与上一个的差值，zigzag后变长编码
+    RunLength = 2,    // 字节：值 + 变长游程
+    XorFloat = 3,     // 浮点：与上一行的位模式异或后变长编码（旧文件，只读）
+    GorillaFloat = 4, // 浮点：与同类事件的上一个值异或，按前导/尾随零位压缩的位流
+    RawBytes = 5      // 字节：原样存储（游程编码反而更大时使用）
+};
+
+const std::uint32_t TELEMETRY_VERSION = 2;
+const std::uint32_t TELEMETRY_MIN_VERSION = 1;  // 读取器仍接受的最旧版本
+const std::size_t TELEMETRY_BLOCK_EVENTS = 4096;
+
+// 一块列式事件（结构体数组）
+struct TelemetryBlock {
+    std::uint64_t tick[TELEMETRY_BLOCK_EVENTS];
+    std::uint8_t kind[TELEMETRY_BLOCK_EVENTS];
+    std::uint8_t player[TELEMETRY_BLOCK_EVENTS];
+    std::uint32_t count[TELEMETRY_BLOCK_EVENTS];
+    float value0[TELEMETRY_BLOCK_EVENTS];
+    float value1[TELEMETRY_BLOCK_EVENTS];
+    std::size_t size = 0;
+    std::atomic<bool> pending{ false };  // 已交给写线程、尚未写完
+};
+
+namespace telemetry_codec {
+
+inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+inline bool getVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        std::uint8_t byte = *p++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline std::uint64_t zigzag(std::int64_t v) { return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63); }
+inline std::int64_t unzigzag(std::uint64_t v) { return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1); }
+
+template <typename T>
+void encodeDelta(std::vector<std::uint8_t>& out, const T* values, std::size_t n) {
+    std::int64_t previous = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::int64_t v = static_cast<std::int64_t>(values[i]);
+        putVarint(out, zigzag(v - previous));
+        previous = v;
+    }
+}
+
+inline void encodeRunLength(std::vector<std::uint8_t>& out, const std::uint8_t* values, std::size_t n) {
+    for (std::size_t i = 0; i < n;) {
+        std::size_t run = 1;
+        while (i + run < n && values[i + run] == values[i]) {
+            ++run;
+        }
+        out.push_back(values[i]);
+        putVarint(out, run);
+        i += run;
+    }
+}
+
+// ========== Gorilla 浮点编码 ==========
+// 同一类事件的数值彼此接近（击球速度、AI误差），不同类事件之间差别很大，
+// 所以按事件类型分别与上一个值异或。异或结果：
+//   0               → 位 0
+//   落在上次的有效位窗口内 → 位 10 + 窗口内的有效位
+//   否则            → 位 11 + 5位前导零数 + 5位(有效位数-1) + 有效位
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<std::uint8_t>& out) : out(out) {}
+
+    void put(std::uint32_t value, int count) {
+        accumulator = (accumulator << count) | (value & ((1ULL << count) - 1));
+        bits += count;
+        while (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<std::uint8_t>(accumulator >> bits));
+        }
+    }
+    void finish() {
+        if (bits > 0) {
+            out.push_back(static_cast<std::uint8_t>(accumulator << (8 - bits)));
+            bits = 0;
+        }
+    }
+
+private:
+    std::vector<std::uint8_t>& out;
+    std::uint64_t accumulator = 0;
+    int bits = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const std::uint8_t* p, const std::uint8_t* end) : p(p), end(end) {}
+
+    bool get(int count, std::uint32_t& value) {
+        while (bits < count) {
+            if (p >= end) return false;
+            accumulator = (accumulator << 8) | *p++;
+            bits += 8;
+        }
+        bits -= count;
+        value = static_cast<std::uint32_t>((accumulator >> bits) & ((1ULL << count) - 1));
+        return true;
+    }
+
+private:
+    const std::uint8_t* p;
+    const std::uint8_t* end;
+    std::uint64_t accumulator = 0;
+    int bits = 0;
+};
+
+// 每种事件各自的异或上下文
+struct GorillaState {
+    std::uint32_t previous = 0;
+    int leading = -1;  // -1 = 还没有窗口
+    int trailing = 0;
+};
+
+inline int leadingZeros(std::uint32_t x) {
+    int n = 0;
+    for (std::uint32_t bit = 0x80000000u; bit && !(x & bit); bit >>= 1) ++n;
+    return n;
+}
+
+inline int trailingZeros(std::uint32_t x) {
+    int n = 0;
+    for (; n < 32 && !(x & (1u << n)); ++n) {}
+    return n;
+}
+
+inline void encodeGorillaFloat(std::vector<std::uint8_t>& out, const float* values, const std::uint8_t* kinds, std::size_t n) {
+    GorillaState states[256];
+    BitWriter writer(out);
+    for (std::size_t i = 0; i < n; ++i) {
+        GorillaState& state = states[kinds[i]];
+        std::uint32_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        std::uint32_t x = bits ^ state.previous;
+        state.previous = bits;
+        if (x == 0) {
+            writer.put(0, 1);
+            continue;
+        }
+        int leading = std::min(leadingZeros(x), 31);
+        int trailing = trailingZeros(x);
+        if (state.leading >= 0 && leading >= state.leading && trailing >= state.trailing) {
+            writer.put(0b10, 2);
+            writer.put(x >> state.trailing, 32 - state.leading - state.trailing);
+            continue;
+        }
+        int length = 32 - leading - trailing;
+        writer.put(0b11, 2);
+        writer.put(static_cast<std::uint32_t>(leading), 5);
+        writer.put(static_cast<std::uint32_t>(length - 1), 5);
+        writer.put(x >> trailing, length);
+        state.leading = leading;
+        state.trailing = trailing;
+    }
+    writer.finish();
+}
+
+// kinds 是已解码的事件类型列
+inline bool decodeGorillaFloat(const std::uint8_t* p, const std::uint8_t* end, const std::uint8_t* kinds, std::size_t n, float* values) {
+    GorillaState states[256];
+    BitReader reader(p, end);
+    for (std::size_t i = 0; i < n; ++i) {
+        GorillaState& state = states[kinds[i]];
+        std::uint32_t control = 0, x = 0;
+        if (!reader.get(1, control)) return false;
+        if (control) {
+            if (!reader.get(1, control)) return false;
+            if (control) {
+                std::uint32_t leading = 0, length = 0;
+                if (!reader.get(5, leading) || !reader.get(5, length)) return false;
+                ++length;
+                if (leading + length > 32) return false;
+                state.leading = static_cast<int>(leading);
+                state.trailing = static_cast<int>(32 - leading - length);
+            }
+            else if (state.leading < 0) {
+                return false;
+            }
+            int length = 32 - state.leading - state.trailing;
+            if (!reader.get(length, x)) return false;
+            x <<= state.trailing;
+        }
+        state.previous ^= x;
+        std::memcpy(&values[i], &state.previous, sizeof(float));
+    }
+    return true;
+}
+
+} // namespace telemetry_codec
+
+// ========== 后台写文件 ==========
+class TelemetryStream {
+public:
+    TelemetryStream() = default;
+    TelemetryStream(const TelemetryStream&) = delete;
+    TelemetryStream& operator=(const TelemetryStream&) = delete;
+    ~TelemetryStream() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        std::fwrite("PTLM", 1, 4, file);
+        writeU32(TELEMETRY_VERSION);
+        running = true;
+        worker = std::thread(&TelemetryStream::flushLoop, this);
+        return true;
+    }
+
+    // 写完所有已提交的块并关闭文件（先对各记录器调用 flush）
+    void close() {
+        if (worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                running = false;
+            }
+            queueReady.notify_one();
+            worker.join();
+        }
+        if (file) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    // 记录器调用：提交一块写满的事件（固定容量队列，不分配）。
+    // 队列已满时不入队并返回false，由记录器丢弃这块
+    bool submit(TelemetryBlock* block) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (queueSize == QUEUE_CAPACITY) {
+                return false;
+            }
+            queue[(queueHead + queueSize) % QUEUE_CAPACITY] = block;
+            ++queueSize;
+        }
+        queueReady.notify_one();
+        return true;
+    }
+
+private:
+    // 每个记录器最多两块在途，队列容量按64个记录器预留
+    static const std::size_t QUEUE_CAPACITY = 128;
+
+    void flushLoop() {
+        for (;;) {
+            TelemetryBlock* block = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return queueSize > 0 || !running; });
+                if (queueSize == 0) {
+                    break;
+                }
+                block = queue[queueHead];
+                queueHead = (queueHead + 1) % QUEUE_CAPACITY;
+                --queueSize;
+            }
+            writeBlock(*block);
+            block->size = 0;
+            block->pending.store(false, std::memory_order_release);
+        }
+        std::fflush(file);
+    }
+
+    void writeBlock(const TelemetryBlock& block) {
+        using namespace telemetry_codec;
+        const std::size_t n = block.size;
+        writeU32(static_cast<std::uint32_t>(n));
+
+        encoded.clear();
+        encodeDelta(encoded, block.tick, n);
+        writeColumn(TelemetryCodec::DeltaVarint);
+        writeByteColumn(block.kind, n);
+        writeByteColumn(block.player, n);
+        encodeDelta(encoded, block.count, n);
+        writeColumn(TelemetryCodec::DeltaVarint);
+        encodeGorillaFloat(encoded, block.value0, block.kind, n);
+        writeColumn(TelemetryCodec::GorillaFloat);
+        encodeGorillaFloat(encoded, block.value1, block.kind, n);
+        writeColumn(TelemetryCodec::GorillaFloat);
+    }
+
+    // 事件类型交替出现时游程很短，游程编码会比原始字节还大
+    void writeByteColumn(const std::uint8_t* values, std::size_t n) {
+        telemetry_codec::encodeRunLength(encoded, values, n);
+        if (encoded.size() <= n) {
+            writeColumn(TelemetryCodec::RunLength);
+            return;
+        }
+        encoded.assign(values, values + n);
+        writeColumn(TelemetryCodec::RawBytes);
+    }
+
+    void writeColumn(TelemetryCodec codec) {
+        std::uint8_t tag = static_cast<std::uint8_t>(codec);
+        std::fwrite(&tag, 1, 1, file);
+        writeU32(static_cast<std::uint32_t>(encoded.size()));
+        std::fwrite(encoded.data(), 1, encoded.size(), file);
+        encoded.clear();
+    }
+
+    void writeU32(std::uint32_t value) {
+        std::uint8_t bytes[4] = {
+            static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8),
+            static_cast<std::uint8_t>(value >> 16), static_cast<std::uint8_t>(value >> 24) };
+        std::fwrite(bytes, 1, 4, file);
+    }
+
+    std::FILE* file = nullptr;
+    std::vector<std::uint8_t> encoded;  // 写线程专用
+
+    TelemetryBlock* queue[QUEUE_CAPACITY] = {};
+    std::size_t queueHead = 0;
+    std::size_t queueSize = 0;
+    bool running = false;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::thread worker;
+};
+
+// ========== 每线程记录器 ==========
+class TelemetryRecorder {
+public:
+    // 缓冲块在构造时一次分配好；游戏两块足够，批量模拟产生事件更快，可多给几块
+    explicit TelemetryRecorder(TelemetryStream& stream, int blockCount = 2)
+        : stream(stream), blocks(new TelemetryBlock[blockCount]), blockCount(blockCount) {}
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+    ~TelemetryRecorder() { flush(); waitIdle(); }
+
+    // 热路径：几次数组写入，满块时交给写线程
+    void record(TelemetryEvent kind, std::uint64_t tick, int player = 0, std::uint32_t count = 0,
+                float value0 = 0.f, float value1 = 0.f) {
+        TelemetryBlock& block = blocks[active];
+        if (block.pending.load(std::memory_order_acquire)) {
+            ++dropped;
+            return;
+        }
+        std::size_t i = block.size;
+        block.tick[i] = tick;
+        block.kind[i] = static_cast<std::uint8_t>(kind);
+        block.player[i] = static_cast<std::uint8_t>(player);
+        block.count[i] = count;
+        block.value0[i] = value0;
+        block.value1[i] = value1;
+        if (++block.size == TELEMETRY_BLOCK_EVENTS) {
+            flush();
+        }
+    }
+
+    // 提交当前块（对局结束或程序退出时调用；关闭TelemetryStream前必须先flush）
+    void flush() {
+        TelemetryBlock& block = blocks[active];
+        if (block.size == 0 || block.pending.load(std::memory_order_acquire)) {
+            return;
+        }
+        // 先标记再入队：写线程可能在 submit 返回前就写完并清除标记
+        block.pending.store(true, std::memory_order_release);
+        if (!stream.submit(&block)) {
+            // 写线程积压太多：整块丢弃并计数，这块留给后续事件继续用
+            dropped += block.size;
+            block.size = 0;
+            block.pending.store(false, std::memory_order_release);
+            return;
+        }
+        active = (active + 1) % blockCount;
+    }
+
+    std::uint64_t droppedEvents() const { return dropped; }
+
+private:
+    void waitIdle() {
+        for (int i = 0; i < blockCount; ++i) {
+            while (blocks[i].pending.load(std::memory_order_acquire)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    TelemetryStream& stream;
+    std::unique_ptr<TelemetryBlock[]> blocks;
+    int blockCount;
+    int active = 0;
+    std::uint64_t dropped = 0;
+};
+
+// ========== 对局事件 → 遥测记录 ==========
+// 模拟钩子转发到这里；负责逻辑帧计数和回合击球数
+class MatchTelemetry {
+public:
+    explicit MatchTelemetry(TelemetryRecorder& recorder) : recorder(recorder) {}
+
+    // 每个模拟步骤之前调用一次：第N步里产生的事件记为tick N（从1开始），游戏和无头模拟都按这个顺序
+    void advanceTick() { ++tick; }
+
+    void paddleHit(int player, float hitRatio, float velocityX, float velocityY) {
+        ++rallyHits;
+        float speed = std::sqrt(velocityX * velocityX + velocityY * velocityY);
+        recorder.record(TelemetryEvent::PaddleHit, tick, player, rallyHits, speed, hitRatio);
+    }
+    void wallBounce() { recorder.record(TelemetryEvent::WallBounce, tick); }
+    void aiDecision(float distance) { recorder.record(TelemetryEvent::AiDecision, tick, 2, 0, distance); }
+    void score(int player) {
+        recorder.record(TelemetryEvent::Score, tick, player, rallyHits);
+        rallyHits = 0;
+    }
+
+private:
+    TelemetryRecorder& recorder;
+    std::uint64_t tick = 0;
+    std::uint32_t rallyHits = 0;
+};
+
+// ========== 读取（供分析工具使用） ==========
+struct TelemetryRecord {
+    std::uint64_t tick = 0;
+    TelemetryEvent kind = TelemetryEvent::PaddleHit;
+    int player = 0;
+    std::uint32_t count = 0;
+    float value0 = 0.f;
+    float value1 = 0.f;
+};
+
+// 每列编码后与未压缩的字节数（未压缩 = 事件数 x 列元素大小）
+struct TelemetryColumnSizes {
+    std::uint64_t encoded[COLUMN_COUNT] = {};
+    std::uint64_t raw[COLUMN_COUNT] = {};
+};
+
+inline std::size_t telemetryColumnElementSize(int column) {
+    switch (column) {
+    case COL_TICK: return sizeof(std::uint64_t);
+    case COL_KIND:
+    case COL_PLAYER: return sizeof(std::uint8_t);
+    case COL_COUNT: return sizeof(std::uint32_t);
+    default: return sizeof(float);
+    }
+}
+
+enum class TelemetryReadResult {
+    Ok,
+    OpenFailed,
+    UnsupportedVersion,  // 文件版本不在 TELEMETRY_MIN_VERSION ~ TELEMETRY_VERSION 之间
+    BadFormat
+};
+
+namespace telemetry_codec {
+
+// 解码文件头之后的所有块，格式错误时返回false
+inline bool readTelemetryBlocks(const std::vector<std::uint8_t>& data, std::size_t pos, std::uint32_t version,
+                                std::vector<TelemetryRecord>& records, TelemetryColumnSizes* sizes) {
+    auto readU32 = [&](std::size_t& at, std::uint32_t& value) {
+        if (at + 4 > data.size()) return false;
+        value = data[at] | (data[at + 1] << 8) | (data[at + 2] << 16) | (static_cast<std::uint32_t>(data[at + 3]) << 24);
+        at += 4;
+        return true;
+    };
+
+    std::vector<std::uint8_t> kinds;
+    std::vector<float> floats;
+    while (pos < data.size()) {
+        std::uint32_t eventCount = 0;
+        if (!readU32(pos, eventCount)) return false;
+        std::size_t base = records.size();
+        records.resize(base + eventCount);
+
+        for (int column = 0; column < COLUMN_COUNT; ++column) {
+            if (pos + 1 > data.size()) return false;
+            TelemetryCodec codec = static_cast<TelemetryCodec>(data[pos++]);
+            if (version < 2 && (codec == TelemetryCodec::GorillaFloat || codec == TelemetryCodec::RawBytes)) return false;
+            std::uint32_t length = 0;
+            if (!readU32(pos, length) || pos + length > data.size()) return false;
+            const std::uint8_t* p = data.data() + pos;
+            const std::uint8_t* end = p + length;
+            pos += length;
+            if (sizes) {
+                sizes->encoded[column] += length;
+                sizes->raw[column] += static_cast<std::uint64_t>(eventCount) * telemetryColumnElementSize(column);
+            }
+
+            if (codec == TelemetryCodec::RawBytes) {
+                if (length != eventCount) return false;
+                for (std::uint32_t i = 0; i < eventCount; ++i) {
+                    if (column == COL_KIND) records[base + i].kind = static_cast<TelemetryEvent>(p[i]);
+                    else records[base + i].player = p[i];
+                }
+                continue;
+            }
+            if (codec == TelemetryCodec::GorillaFloat) {
+                // 类型列在数值列之前，已经解码
+                kinds.resize(eventCount);
+                floats.resize(eventCount);
+                for (std::uint32_t i = 0; i < eventCount; ++i) {
+                    kinds[i] = static_cast<std::uint8_t>(records[base + i].kind);
+                }
+                if (!decodeGorillaFloat(p, end, kinds.data(), eventCount, floats.data())) return false;
+                for (std::uint32_t i = 0; i < eventCount; ++i) {
+                    if (column == COL_VALUE0) records[base + i].value0 = floats[i];
+                    else records[base + i].value1 = floats[i];
+                }
+                continue;
+            }
+
+            std::int64_t previousInt = 0;
+            std::uint32_t previousBits = 0;
+            for (std::uint32_t i = 0; i < eventCount;) {
+                TelemetryRecord& record = records[base + i];
+                std::uint64_t raw = 0;
+                if (codec == TelemetryCodec::RunLength) {
+                    if (p >= end) return false;
+                    std::uint8_t value = *p++;
+                    if (!getVarint(p, end, raw) || i + raw > eventCount) return false;
+                    for (std::uint64_t r = 0; r < raw; ++r, ++i) {
+                        TelemetryRecord& target = records[base + i];
+                        if (column == COL_KIND) target.kind = static_cast<TelemetryEvent>(value);
+                        else target.player = value;
+                    }
+                    continue;
+                }
+                if (!getVarint(p, end, raw)) return false;
+                if (codec == TelemetryCodec::DeltaVarint) {
+                    previousInt += unzigzag(raw);
+                    if (column == COL_TICK) record.tick = static_cast<std::uint64_t>(previousInt);
+                    else record.count = static_cast<std::uint32_t>(previousInt);
+                }
+                else if (codec == TelemetryCodec::XorFloat) {
+                    std::uint32_t x = static_cast<std::uint32_t>(raw);
+                    x = (x >> 24) | ((x >> 8) & 0xff00) | ((x << 8) & 0xff0000) | (x << 24);
+                    previousBits ^= x;
+                    float value;
+                    std::memcpy(&value, &previousBits, sizeof(value));
+                    if (column == COL_VALUE0) record.value0 = value;
+                    else record.value1 = value;
+                }
+                else {
+                    return false;
+                }
+                ++i;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace telemetry_codec
+
+// 读取整个文件；sizes非空时累计各列大小
+inline TelemetryReadResult readTelemetryFile(const std::string& path, std::vector<TelemetryRecord>& records,
+                                             TelemetryColumnSizes* sizes = nullptr) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return TelemetryReadResult::OpenFailed;
+    }
+    std::vector<std::uint8_t> data;
+    std::uint8_t buffer[65536];
+    std::size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    std::fclose(file);
+
+    if (data.size() < 8 || std::memcmp(data.data(), "PTLM", 4) != 0) {
+        return TelemetryReadResult::BadFormat;
+    }
+    std::uint32_t version = data[4] | (data[5] << 8) | (data[6] << 16) | (static_cast<std::uint32_t>(data[7]) << 24);
+    if (version < TELEMETRY_MIN_VERSION || version > TELEMETRY_VERSION) {
+        return TelemetryReadResult::UnsupportedVersion;
+    }
+    if (!telemetry_codec::readTelemetryBlocks(data, 8, version, records, sizes)) {
+        return TelemetryReadResult::BadFormat;
+    }
+    return TelemetryReadResult::Ok;
+}
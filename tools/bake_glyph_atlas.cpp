@@ -0,0 +1,193 @@
+﻿// 离线烘焙字形图集：把游戏用到的字号的可打印ASCII字形光栅化成一张PNG和一份度量表
+// 用法: bake_glyph_atlas [字体.ttf] [输出前缀]
+//       bake_glyph_atlas --verify [字体.ttf] [图集前缀]
+//   默认读 font/Maltais_Learlex.ttf，输出 font/Maltais_Learlex.atlas 和 font/Maltais_Learlex.atlas.png
+// 字形、字距和纹理坐标都直接取自SFML的页面纹理，用它烘焙的图集 AtlasText 排版结果与 sf::Text 一致。
+// 仓库里提交的图集是没有SFML的机器上用 bake_glyph_atlas_freetype 生成的（按SFML 3.0的算法复现，
+// 页面布局相同）；--verify 逐项对照 sf::Font 检查提交的图集：行距、字形度量、字距和字形像素的alpha，
+// 有任何不一致就以失败退出（CTest 的 glyph_atlas_matches_sfml）。不一致时用本工具重新烘焙并提交。
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../glyph_atlas.h"
+
+namespace {
+
+// 对照 sf::Font 检查已烘焙的图集，返回不一致的项数
+int verifyAtlas(const sf::Font& font, const std::string& metricsPath) {
+    GlyphAtlas atlas;
+    sf::Image atlasImage;
+    if (!atlas.loadFromFile(metricsPath) || !atlasImage.loadFromFile(metricsPath + ".png")) {
+        std::fprintf(stderr, "图集加载失败: %s\n", metricsPath.c_str());
+        return 1;
+    }
+
+    // 先光栅化全部字形，再读回页面纹理
+    for (unsigned size : GlyphAtlas::BAKED_SIZES) {
+        for (char32_t c = GlyphAtlas::FIRST_CHAR; c <= GlyphAtlas::LAST_CHAR; ++c) {
+            font.getGlyph(c, size, false);
+        }
+    }
+
+    int mismatches = 0;
+    auto report = [&](unsigned size, char32_t c, const char* what) {
+        if (++mismatches <= 20) {
+            std::fprintf(stderr, "不一致: 字号 %u 字符 '%c' %s\n", size, static_cast<char>(c), what);
+        }
+    };
+    for (unsigned size : GlyphAtlas::BAKED_SIZES) {
+        if (!atlas.hasSize(size)) {
+            report(size, U' ', "缺少字号");
+            continue;
+        }
+        if (atlas.lineSpacing(size) != font.getLineSpacing(size)) {
+            report(size, U' ', "行距");
+        }
+        sf::Image page = font.getTexture(size).copyToImage();
+        for (char32_t c = GlyphAtlas::FIRST_CHAR; c <= GlyphAtlas::LAST_CHAR; ++c) {
+            const AtlasGlyph* baked = atlas.findGlyph(size, c);
+            if (!font.hasGlyph(c)) {
+                if (baked) report(size, c, "多出的字形");
+                continue;
+            }
+            if (!baked) {
+                report(size, c, "缺少字形");
+                continue;
+            }
+            const sf::Glyph& glyph = font.getGlyph(c, size, false);
+            if (baked->advance != glyph.advance || baked->bounds != glyph.bounds ||
+                baked->textureRect.size != glyph.textureRect.size) {
+                report(size, c, "字形度量");
+                continue;
+            }
+            bool samePixels = true;
+            for (int y = 0; y < glyph.textureRect.size.y && samePixels; ++y) {
+                for (int x = 0; x < glyph.textureRect.size.x; ++x) {
+                    sf::Vector2u bakedPixel(static_cast<unsigned>(baked->textureRect.position.x + x),
+                                            static_cast<unsigned>(baked->textureRect.position.y + y));
+                    sf::Vector2u fontPixel(static_cast<unsigned>(glyph.textureRect.position.x + x),
+                                           static_cast<unsigned>(glyph.textureRect.position.y + y));
+                    if (atlasImage.getPixel(bakedPixel).a != page.getPixel(fontPixel).a) {
+                        samePixels = false;
+                        break;
+                    }
+                }
+            }
+            if (!samePixels) {
+                report(size, c, "字形像素");
+            }
+        }
+        for (char32_t first = GlyphAtlas::FIRST_CHAR; first <= GlyphAtlas::LAST_CHAR; ++first) {
+            for (char32_t second = GlyphAtlas::FIRST_CHAR; second <= GlyphAtlas::LAST_CHAR; ++second) {
+                if (atlas.kerning(size, first, second) != font.getKerning(first, second, size)) {
+                    report(size, first, "字距");
+                }
+            }
+        }
+    }
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool verify = argc > 1 && std::string(argv[1]) == "--verify";
+    if (verify) {
+        --argc;
+        ++argv;
+    }
+    std::string fontPath = argc > 1 ? argv[1] : "font/Maltais_Learlex.ttf";
+    std::string outputPrefix = argc > 2 ? argv[2] : "font/Maltais_Learlex";
+    std::string metricsPath = outputPrefix + ".atlas";
+    std::string imagePath = metricsPath + ".png";
+
+    sf::Font font;
+    if (!font.openFromFile(fontPath)) {
+        std::fprintf(stderr, "字体加载失败: %s\n", fontPath.c_str());
+        return 1;
+    }
+
+    if (verify) {
+        int mismatches = verifyAtlas(font, metricsPath);
+        if (mismatches > 0) {
+            std::fprintf(stderr, "%s 与 sf::Font 有 %d 处不一致，请用 bake_glyph_atlas 重新烘焙\n", metricsPath.c_str(), mismatches);
+            return 1;
+        }
+        std::printf("%s 与 sf::Font 一致\n", metricsPath.c_str());
+        return 0;
+    }
+
+    // 先光栅化每个字号的全部字形，SFML把同一字号的字形放在同一张页面纹理里
+    for (unsigned size : GlyphAtlas::BAKED_SIZES) {
+        for (char32_t c = GlyphAtlas::FIRST_CHAR; c <= GlyphAtlas::LAST_CHAR; ++c) {
+            font.getGlyph(c, size, false);
+        }
+    }
+
+    // 各字号页面纵向拼接成一张图集（页面四周的透明边距也一起复制，保留采样用的1像素余量）
+    std::vector<sf::Image> pages;
+    unsigned atlasWidth = 0;
+    unsigned atlasHeight = 0;
+    for (unsigned size : GlyphAtlas::BAKED_SIZES) {
+        pages.push_back(font.getTexture(size).copyToImage());
+        atlasWidth = std::max(atlasWidth, pages.back().getSize().x);
+        atlasHeight += pages.back().getSize().y;
+    }
+    sf::Image atlas({ atlasWidth, atlasHeight }, sf::Color::Transparent);
+
+    std::FILE* metrics = std::fopen(metricsPath.c_str(), "w");
+    if (!metrics) {
+        std::fprintf(stderr, "无法写入: %s\n", metricsPath.c_str());
+        return 1;
+    }
+    // 度量表记录图集文件名（相对度量表所在目录）
+    std::string imageName = imagePath.substr(imagePath.find_last_of("/\\") + 1);
+    std::fprintf(metrics, "pong-glyph-atlas %d\nimage %s\n", GlyphAtlas::FORMAT_VERSION, imageName.c_str());
+
+    unsigned pageTop = 0;
+    std::size_t glyphCount = 0;
+    std::size_t kerningCount = 0;
+    for (std::size_t page = 0; page < pages.size(); ++page) {
+        unsigned size = GlyphAtlas::BAKED_SIZES[page];
+        if (!atlas.copy(pages[page], { 0, pageTop })) {
+            std::fprintf(stderr, "拼接页面失败: 字号 %u\n", size);
+            return 1;
+        }
+        std::fprintf(metrics, "size %u %g\n", size, font.getLineSpacing(size));
+
+        for (char32_t c = GlyphAtlas::FIRST_CHAR; c <= GlyphAtlas::LAST_CHAR; ++c) {
+            if (!font.hasGlyph(c)) {
+                continue;
+            }
+            const sf::Glyph& glyph = font.getGlyph(c, size, false);
+            std::fprintf(metrics, "glyph %u %u %g %g %g %g %g %d %d %d %d\n", size, static_cast<unsigned>(c), glyph.advance,
+                glyph.bounds.position.x, glyph.bounds.position.y, glyph.bounds.size.x, glyph.bounds.size.y,
+                glyph.textureRect.position.x, glyph.textureRect.position.y + static_cast<int>(pageTop),
+                glyph.textureRect.size.x, glyph.textureRect.size.y);
+            ++glyphCount;
+        }
+        // 只记录非零字距
+        for (char32_t first = GlyphAtlas::FIRST_CHAR; first <= GlyphAtlas::LAST_CHAR; ++first) {
+            for (char32_t second = GlyphAtlas::FIRST_CHAR; second <= GlyphAtlas::LAST_CHAR; ++second) {
+                float kerning = font.getKerning(first, second, size);
+                if (kerning != 0.f) {
+                    std::fprintf(metrics, "kern %u %u %u %g\n", size, static_cast<unsigned>(first),
+                        static_cast<unsigned>(second), kerning);
+                    ++kerningCount;
+                }
+            }
+        }
+        pageTop += pages[page].getSize().y;
+    }
+    std::fclose(metrics);
+
+    if (!atlas.saveToFile(imagePath)) {
+        std::fprintf(stderr, "无法写入: %s\n", imagePath.c_str());
+        return 1;
+    }
+    std::printf("图集 %ux%u, 字形 %zu, 字距对 %zu\n", atlasWidth, atlasHeight, glyphCount, kerningCount);
+    std::printf("已写入 %s 和 %s\n", metricsPath.c_str(), imagePath.c_str());
+    return 0;
+}
@@ -0,0 +1,332 @@
+﻿// 不依赖SFML的字形图集烘焙：直接调用FreeType，按SFML 3.0的字体实现复现 bake_glyph_atlas 的输出
+// 用法: bake_glyph_atlas_freetype [字体.ttf] [输出前缀]
+//   默认读 font/Maltais_Learlex.ttf，输出 font/Maltais_Learlex.atlas 和 font/Maltais_Learlex.atlas.png
+// 仓库里提交的两个图集文件就是用它生成的（构建机上没有SFML）。复现的部分：
+//   字形  Font::loadGlyph：FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT，前进宽度取整，四周留2像素
+//   装箱  Font::Page / findGlyphRect：128x128起步、按行装箱、空间不够时宽高都翻倍，左上角2x2白块
+//   字距  Font::getKerning：FT_KERNING_UNFITTED 加上自动微调的 lsb/rsb 修正后向下取整
+//   行距  size->metrics.height / 64
+// 缺字的字符和SFML一样共用 .notdef 字形（按字形索引缓存，只占一次纹理空间）。
+// 有SFML的机器上用 bake_glyph_atlas --verify 检查提交的度量表与 sf::Font 是否一致；
+// SFML自带的FreeType版本不同时，个别字形可能差1像素，这时以 bake_glyph_atlas 的输出为准。
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_GLYPH_H
+#include <png.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 与 GlyphAtlas 保持一致（glyph_atlas.h 依赖SFML，这里不能包含）
+const int FORMAT_VERSION = 1;
+const unsigned BAKED_SIZES[] = { 24, 30, 36, 48, 60 };
+const char32_t FIRST_CHAR = U' ';
+const char32_t LAST_CHAR = U'~';
+
+const unsigned GLYPH_PADDING = 2;
+
+struct Pixel {
+    std::uint8_t r, g, b, a;
+};
+const Pixel TRANSPARENT_WHITE = { 255, 255, 255, 0 };
+
+struct Rect {
+    int x = 0, y = 0, width = 0, height = 0;
+};
+
+struct Glyph {
+    float advance = 0.f;
+    int lsbDelta = 0;
+    int rsbDelta = 0;
+    float left = 0.f, top = 0.f, width = 0.f, height = 0.f;  // 相对基线的字形矩形
+    Rect textureRect;
+};
+
+// 一个字号的页面纹理（对应 sf::Font::Page）
+struct Page {
+    struct Row {
+        unsigned width;
+        unsigned top;
+        unsigned height;
+    };
+
+    unsigned width = 128;
+    unsigned height = 128;
+    std::vector<Pixel> pixels;
+    std::list<Row> rows;
+    unsigned nextRow = 3;
+    std::map<FT_UInt, Glyph> glyphs;  // 按字形索引缓存
+
+    Page() : pixels(static_cast<std::size_t>(width) * height, TRANSPARENT_WHITE) {
+        // 保留给下划线用的2x2白块
+        for (unsigned y = 0; y < 2; ++y) {
+            for (unsigned x = 0; x < 2; ++x) {
+                pixels[y * width + x] = { 255, 255, 255, 255 };
+            }
+        }
+    }
+
+    void grow() {
+        std::vector<Pixel> grown(static_cast<std::size_t>(width) * 2 * height * 2, TRANSPARENT_WHITE);
+        for (unsigned y = 0; y < height; ++y) {
+            std::copy_n(&pixels[y * width], width, &grown[y * width * 2]);
+        }
+        pixels.swap(grown);
+        width *= 2;
+        height *= 2;
+    }
+
+    // 与 Font::findGlyphRect 相同：选高度比例在0.7~1之间且放得下的第一行，否则新开一行（比字形高10%）
+    Rect allocate(unsigned w, unsigned h) {
+        Row* row = nullptr;
+        float bestRatio = 0.f;
+        for (auto it = rows.begin(); it != rows.end() && !row; ++it) {
+            float ratio = static_cast<float>(h) / static_cast<float>(it->height);
+            if (ratio < 0.7f || ratio > 1.f) continue;
+            if (w > width - it->width) continue;
+            if (ratio < bestRatio) continue;
+            row = &*it;
+            bestRatio = ratio;
+        }
+        if (!row) {
+            unsigned rowHeight = h + h / 10;
+            while (nextRow + rowHeight >= height || w >= width) {
+                grow();
+            }
+            rows.push_back({ 0, nextRow, rowHeight });
+            nextRow += rowHeight;
+            row = &rows.back();
+        }
+        Rect rect;
+        rect.x = static_cast<int>(row->width);
+        rect.y = static_cast<int>(row->top);
+        rect.width = static_cast<int>(w);
+        rect.height = static_cast<int>(h);
+        row->width += w;
+        return rect;
+    }
+};
+
+class Font {
+public:
+    ~Font() {
+        if (face) FT_Done_Face(face);
+        if (library) FT_Done_FreeType(library);
+    }
+
+    bool open(const std::string& path) {
+        if (FT_Init_FreeType(&library) != 0 || FT_New_Face(library, path.c_str(), 0, &face) != 0) {
+            return false;
+        }
+        return FT_Select_Charmap(face, FT_ENCODING_UNICODE) == 0;
+    }
+
+    bool hasGlyph(char32_t c) const { return FT_Get_Char_Index(face, c) != 0; }
+
+    float lineSpacing(unsigned size) {
+        setSize(size);
+        return static_cast<float>(face->size->metrics.height) / 64.f;
+    }
+
+    const Glyph& glyph(char32_t c, unsigned size) {
+        Page& page = pages[size];
+        FT_UInt index = FT_Get_Char_Index(face, c);
+        auto cached = page.glyphs.find(index);
+        if (cached != page.glyphs.end()) {
+            return cached->second;
+        }
+        return page.glyphs[index] = loadGlyph(c, size, page);
+    }
+
+    float kerning(char32_t first, char32_t second, unsigned size) {
+        if (first == 0 || second == 0) {
+            return 0.f;
+        }
+        float firstRsbDelta = static_cast<float>(glyph(first, size).rsbDelta);
+        float secondLsbDelta = static_cast<float>(glyph(second, size).lsbDelta);
+        setSize(size);
+        FT_Vector kerning = { 0, 0 };
+        if (FT_HAS_KERNING(face)) {
+            FT_Get_Kerning(face, FT_Get_Char_Index(face, first), FT_Get_Char_Index(face, second), FT_KERNING_UNFITTED, &kerning);
+        }
+        if (!FT_IS_SCALABLE(face)) {
+            return static_cast<float>(kerning.x);
+        }
+        return std::floor((secondLsbDelta - firstRsbDelta + static_cast<float>(kerning.x) + 32) / 64.f);
+    }
+
+    const Page& page(unsigned size) { return pages[size]; }
+
+private:
+    void setSize(unsigned size) {
+        if (face->size->metrics.x_ppem != size) {
+            FT_Set_Pixel_Sizes(face, 0, size);
+        }
+    }
+
+    Glyph loadGlyph(char32_t c, unsigned size, Page& page) {
+        Glyph result;
+        setSize(size);
+        if (FT_Load_Char(face, c, FT_LOAD_TARGET_NORMAL | FT_LOAD_FORCE_AUTOHINT) != 0) {
+            return result;
+        }
+        FT_Glyph description;
+        if (FT_Get_Glyph(face->glyph, &description) != 0) {
+            return result;
+        }
+        FT_Glyph_To_Bitmap(&description, FT_RENDER_MODE_NORMAL, nullptr, 1);
+        FT_BitmapGlyph bitmapGlyph = reinterpret_cast<FT_BitmapGlyph>(description);
+        const FT_Bitmap& bitmap = bitmapGlyph->bitmap;
+
+        result.advance = static_cast<float>(bitmapGlyph->root.advance.x >> 16);
+        result.lsbDelta = static_cast<int>(face->glyph->lsb_delta);
+        result.rsbDelta = static_cast<int>(face->glyph->rsb_delta);
+
+        if (bitmap.width > 0 && bitmap.rows > 0) {
+            unsigned width = bitmap.width + 2 * GLYPH_PADDING;
+            unsigned height = bitmap.rows + 2 * GLYPH_PADDING;
+            Rect rect = page.allocate(width, height);
+
+            result.textureRect = { rect.x + static_cast<int>(GLYPH_PADDING), rect.y + static_cast<int>(GLYPH_PADDING),
+                static_cast<int>(bitmap.width), static_cast<int>(bitmap.rows) };
+            result.left = static_cast<float>(bitmapGlyph->left);
+            result.top = static_cast<float>(-bitmapGlyph->top);
+            result.width = static_cast<float>(bitmap.width);
+            result.height = static_cast<float>(bitmap.rows);
+
+            // 整个矩形（含边距）先填透明白，再写入字形的alpha
+            for (unsigned y = 0; y < height; ++y) {
+                std::fill_n(&page.pixels[(rect.y + y) * page.width + rect.x], width, TRANSPARENT_WHITE);
+            }
+            const std::uint8_t* source = bitmap.buffer;
+            for (unsigned y = 0; y < bitmap.rows; ++y, source += bitmap.pitch) {
+                Pixel* target = &page.pixels[(result.textureRect.y + y) * page.width + result.textureRect.x];
+                for (unsigned x = 0; x < bitmap.width; ++x) {
+                    target[x].a = bitmap.pixel_mode == FT_PIXEL_MODE_MONO
+                        ? ((source[x / 8] & (1 << (7 - (x % 8)))) ? 255 : 0)
+                        : source[x];
+                }
+            }
+        }
+        FT_Done_Glyph(description);
+        return result;
+    }
+
+    FT_Library library = nullptr;
+    FT_Face face = nullptr;
+    std::map<unsigned, Page> pages;
+};
+
+bool savePng(const std::string& path, unsigned width, unsigned height, const std::vector<Pixel>& pixels) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    if (!info || setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        std::fclose(file);
+        return false;
+    }
+    png_init_io(png, file);
+    png_set_compression_level(png, 9);
+    png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE,
+        PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    for (unsigned y = 0; y < height; ++y) {
+        png_write_row(png, reinterpret_cast<png_const_bytep>(&pixels[static_cast<std::size_t>(y) * width]));
+    }
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+    return std::fclose(file) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string fontPath = argc > 1 ? argv[1] : "font/Maltais_Learlex.ttf";
+    std::string outputPrefix = argc > 2 ? argv[2] : "font/Maltais_Learlex";
+    std::string metricsPath = outputPrefix + ".atlas";
+    std::string imagePath = metricsPath + ".png";
+
+    Font font;
+    if (!font.open(fontPath)) {
+        std::fprintf(stderr, "字体加载失败: %s\n", fontPath.c_str());
+        return 1;
+    }
+
+    // 与 bake_glyph_atlas 相同的顺序：先光栅化每个字号的全部字形
+    for (unsigned size : BAKED_SIZES) {
+        for (char32_t c = FIRST_CHAR; c <= LAST_CHAR; ++c) {
+            font.glyph(c, size);
+        }
+    }
+
+    // 各字号页面纵向拼接，页面以外的区域是透明黑（sf::Color::Transparent）
+    unsigned atlasWidth = 0;
+    unsigned atlasHeight = 0;
+    for (unsigned size : BAKED_SIZES) {
+        atlasWidth = std::max(atlasWidth, font.page(size).width);
+        atlasHeight += font.page(size).height;
+    }
+    std::vector<Pixel> atlas(static_cast<std::size_t>(atlasWidth) * atlasHeight, Pixel{ 0, 0, 0, 0 });
+
+    std::FILE* metrics = std::fopen(metricsPath.c_str(), "w");
+    if (!metrics) {
+        std::fprintf(stderr, "无法写入: %s\n", metricsPath.c_str());
+        return 1;
+    }
+    std::string imageName = imagePath.substr(imagePath.find_last_of("/\\") + 1);
+    std::fprintf(metrics, "pong-glyph-atlas %d\nimage %s\n", FORMAT_VERSION, imageName.c_str());
+
+    unsigned pageTop = 0;
+    std::size_t glyphCount = 0;
+    std::size_t kerningCount = 0;
+    for (unsigned size : BAKED_SIZES) {
+        const Page& page = font.page(size);
+        for (unsigned y = 0; y < page.height; ++y) {
+            std::copy_n(&page.pixels[y * page.width], page.width, &atlas[(pageTop + y) * atlasWidth]);
+        }
+        std::fprintf(metrics, "size %u %g\n", size, font.lineSpacing(size));
+
+        for (char32_t c = FIRST_CHAR; c <= LAST_CHAR; ++c) {
+            if (!font.hasGlyph(c)) {
+                continue;
+            }
+            const Glyph& glyph = font.glyph(c, size);
+            std::fprintf(metrics, "glyph %u %u %g %g %g %g %g %d %d %d %d\n", size, static_cast<unsigned>(c), glyph.advance,
+                glyph.left, glyph.top, glyph.width, glyph.height,
+                glyph.textureRect.x, glyph.textureRect.y + static_cast<int>(pageTop),
+                glyph.textureRect.width, glyph.textureRect.height);
+            ++glyphCount;
+        }
+        for (char32_t first = FIRST_CHAR; first <= LAST_CHAR; ++first) {
+            for (char32_t second = FIRST_CHAR; second <= LAST_CHAR; ++second) {
+                float kerning = font.kerning(first, second, size);
+                if (kerning != 0.f) {
+                    std::fprintf(metrics, "kern %u %u %u %g\n", size, static_cast<unsigned>(first),
+                        static_cast<unsigned>(second), kerning);
+                    ++kerningCount;
+                }
+            }
+        }
+        pageTop += page.height;
+    }
+    std::fclose(metrics);
+
+    if (!savePng(imagePath, atlasWidth, atlasHeight, atlas)) {
+        std::fprintf(stderr, "无法写入: %s\n", imagePath.c_str());
+        return 1;
+    }
+    std::printf("图集 %ux%u, 字形 %zu, 字距对 %zu\n", atlasWidth, atlasHeight, glyphCount, kerningCount);
+    std::printf("已写入 %s 和 %s\n", metricsPath.c_str(), imagePath.c_str());
+    return 0;
+}
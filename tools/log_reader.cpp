@@ -0,0 +1,99 @@
+﻿// 二进制日志读取工具：把 --log-binary 写出的日志还原成文本
+// 用法: log_reader <日志文件> [--level debug|info|warn|error]
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../logger.h"
+
+namespace {
+
+bool readBytes(std::FILE* file, void* out, std::size_t size) {
+    return std::fread(out, 1, size, file) == size;
+}
+
+LogLevel parseLevel(const char* name) {
+    if (std::strcmp(name, "debug") == 0) return LogLevel::Debug;
+    if (std::strcmp(name, "warn") == 0) return LogLevel::Warn;
+    if (std::strcmp(name, "error") == 0) return LogLevel::Error;
+    return LogLevel::Info;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "用法: %s <日志文件> [--level debug|info|warn|error]\n", argv[0]);
+        return 1;
+    }
+    LogLevel minimumLevel = LogLevel::Debug;
+    if (argc > 3 && std::strcmp(argv[2], "--level") == 0) {
+        minimumLevel = parseLevel(argv[3]);
+    }
+
+    std::FILE* file = std::fopen(argv[1], "rb");
+    char magic[4] = {};
+    if (!file || !readBytes(file, magic, 4) || std::memcmp(magic, "PLOG", 4) != 0 ||
+        std::fgetc(file) != Logger::BINARY_VERSION) {
+        std::fprintf(stderr, "不是有效的日志文件: %s\n", argv[1]);
+        return 1;
+    }
+
+    std::unordered_map<std::uint32_t, std::string> formats;
+    std::string strings[Logger::MAX_ARGS];
+    LogValue values[Logger::MAX_ARGS];
+    char message[1024];
+    std::size_t records = 0;
+
+    for (int tag = std::fgetc(file); tag != EOF; tag = std::fgetc(file)) {
+        std::uint32_t id = 0;
+        if (!readBytes(file, &id, sizeof(id))) {
+            break;
+        }
+        if (tag == 1) {
+            std::uint16_t length = 0;
+            if (!readBytes(file, &length, sizeof(length))) break;
+            std::string format(length, '\0');
+            if (!readBytes(file, format.data(), length)) break;
+            formats[id] = format;
+            continue;
+        }
+        if (tag != 2) {
+            std::fprintf(stderr, "日志已损坏（未知标记 %d）\n", tag);
+            return 1;
+        }
+
+        int level = std::fgetc(file);
+        std::uint64_t timestamp = 0;
+        if (!readBytes(file, &timestamp, sizeof(timestamp))) break;
+        int argCount = std::fgetc(file);
+        if (argCount < 0 || argCount > Logger::MAX_ARGS) break;
+        bool ok = true;
+        for (int i = 0; i < argCount && ok; ++i) {
+            values[i].type = static_cast<LogArgType>(std::fgetc(file));
+            if (values[i].type == LogArgType::String) {
+                int length = std::fgetc(file);
+                strings[i].assign(length > 0 ? length : 0, '\0');
+                ok = length >= 0 && readBytes(file, strings[i].data(), strings[i].size());
+                values[i].s = strings[i].c_str();
+            }
+            else {
+                ok = readBytes(file, &values[i].i, 8);
+            }
+        }
+        if (!ok) break;
+
+        if (static_cast<LogLevel>(level) < minimumLevel) {
+            continue;
+        }
+        auto format = formats.find(id);
+        formatLogMessage(format != formats.end() ? format->second.c_str() : "<未知格式>", values, argCount,
+            message, sizeof(message));
+        std::printf("[%9.3f %-5s] %s\n", timestamp / 1e9, logLevelName(static_cast<LogLevel>(level)), message);
+        ++records;
+    }
+    std::fclose(file);
+    std::fprintf(stderr, "共 %zu 条记录\n", records);
+    return 0;
+}
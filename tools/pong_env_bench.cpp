@@ -0,0 +1,72 @@
+﻿// 强化学习批量环境吞吐测试：随机动作推进一批环境，报告每秒环境步数
+// 用法: pong_env_bench [环境数] [step次数] [--threads n] [--frame-skip k] [--self-play]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "../pong_env.h"
+
+int main(int argc, char** argv) {
+    int envCount = 256;
+    int steps = 20000;
+    int threads = 0;
+    pong::EnvConfig config;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--frame-skip") == 0 && i + 1 < argc) {
+            config.frameSkip = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--self-play") == 0) {
+            config.selfPlay = true;
+        }
+        else if (positional++ == 0) {
+            envCount = std::max(1, std::atoi(argv[i]));
+        }
+        else {
+            steps = std::max(1, std::atoi(argv[i]));
+        }
+    }
+
+    pong::VectorEnv<float> env(envCount, config, threads);
+    const std::size_t agentCount = static_cast<std::size_t>(envCount) * env.agentsPerEnv();
+    // 调用方持有的连续缓冲区（训练时通常是共享内存里的numpy数组）
+    std::vector<float> observations(agentCount * pong::ENV_OBSERVATION_SIZE);
+    std::vector<float> rewards(agentCount);
+    std::vector<std::uint8_t> dones(envCount);
+    std::vector<std::int32_t> actions(agentCount);
+
+    env.reset(observations.data());
+    std::uint32_t rng = 12345;
+    long long episodes = 0;
+    double rewardSum = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step) {
+        // 每8步换一次随机动作，避免球拍原地抖动
+        if (step % 8 == 0) {
+            for (std::int32_t& action : actions) {
+                rng = rng * 1664525u + 1013904223u;
+                action = static_cast<std::int32_t>((rng >> 16) % pong::ENV_ACTION_COUNT);
+            }
+        }
+        env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+        for (int i = 0; i < envCount; ++i) {
+            episodes += dones[i] != pong::EnvRunning;
+        }
+        for (std::size_t i = 0; i < agentCount; i += env.agentsPerEnv()) {
+            rewardSum += rewards[i];
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double envSteps = static_cast<double>(envCount) * steps;
+    std::printf("环境: %d x %d 智能体, 线程 %d, 跳帧 %d\n", envCount, env.agentsPerEnv(), env.threadCount(), config.frameSkip);
+    std::printf("完成对局: %lld, 智能体1累计奖励: %.0f\n", episodes, rewardSum);
+    std::printf("耗时 %.3f 秒: %.0f 环境步/秒, %.0f 物理步/秒\n", seconds, envSteps / seconds,
+        envSteps * config.frameSkip / seconds);
+    return 0;
+}
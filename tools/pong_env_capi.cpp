@@ -0,0 +1,48 @@
+﻿// 强化学习批量环境的C接口，编译成动态库供Python（ctypes/cffi）调用
+//   g++ -std=c++17 -O2 -shared -fPIC -pthread tools/pong_env_capi.cpp -o libpong_env.so
+// 缓冲区由调用方分配（例如numpy数组或共享内存），形状见 pong_env.h
+#include <cstdint>
+#include "../pong_env.h"
+
+#ifdef _WIN32
+#define PONG_ENV_API extern "C" __declspec(dllexport)
+#else
+#define PONG_ENV_API extern "C" __attribute__((visibility("default")))
+#endif
+
+using Env = pong::VectorEnv<float>;
+
+// threads为0时使用全部硬件线程；失败返回空指针
+// （内存不足或创建线程失败时构造函数会抛异常，异常不能穿过C接口传给调用方）
+PONG_ENV_API void* pong_env_create(int envCount, int frameSkip, int selfPlay, std::uint32_t seed, int threads) {
+    if (envCount <= 0 || frameSkip <= 0) {
+        return nullptr;
+    }
+    try {
+        pong::EnvConfig config;
+        config.frameSkip = frameSkip;
+        config.selfPlay = selfPlay != 0;
+        config.seed = seed;
+        return new Env(envCount, config, threads);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+PONG_ENV_API void pong_env_destroy(void* env) {
+    delete static_cast<Env*>(env);
+}
+
+PONG_ENV_API int pong_env_observation_size() { return pong::ENV_OBSERVATION_SIZE; }
+PONG_ENV_API int pong_env_action_count() { return pong::ENV_ACTION_COUNT; }
+PONG_ENV_API int pong_env_agents_per_env(void* env) { return static_cast<Env*>(env)->agentsPerEnv(); }
+
+PONG_ENV_API void pong_env_reset(void* env, float* observations) {
+    static_cast<Env*>(env)->reset(observations);
+}
+
+PONG_ENV_API void pong_env_step(void* env, const std::int32_t* actions, float* observations, float* rewards,
+                                std::uint8_t* dones) {
+    static_cast<Env*>(env)->step(actions, observations, rewards, dones);
+}
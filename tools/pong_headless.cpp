@@ -0,0 +1,186 @@
+﻿// 无头批量模拟：不创建窗口、不加载资源，只跑对局物理
+// 用法: pong_headless [对局数] [--two-players] [--fixed] [--telemetry <文件>] [--alloc-check]
+//   --fixed        使用Q16.16定点物理，输出的校验值在任何编译选项下都应一致
+//   --telemetry    把击球、得分、AI决策事件写入遥测文件（用 telemetry_reader 查看）
+//   --alloc-check  第一局热身后，后续对局只要有一次堆分配就以失败退出
+//                  （需要以 PONG_ALLOC_TRACKING 编译，CMake 构建的 pong_headless_alloc 就是这样）
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "../pong_sim.h"
+#include "../telemetry.h"
+#include "../alloc_tracker.h"
+
+namespace {
+
+const float TICK = 1.0f / 240.0f;          // 与游戏帧率上限一致的固定步长
+const long long MAX_TICKS_PER_MATCH = 240LL * 60 * 10;  // 防止无限回合
+
+struct MatchResult {
+    int player1Score = 0;
+    int player2Score = 0;
+    long long ticks = 0;
+    std::uint64_t checksum = 0;
+};
+
+// 对最终状态做FNV-1a校验（float按位，定点数按原始整数）
+template <typename Num>
+std::uint64_t stateChecksum(const pong::BasicMatchState<Num>& match) {
+    const Num values[] = {
+        match.leftPaddle.x, match.leftPaddle.y, match.rightPaddle.x, match.rightPaddle.y,
+        match.ball.x, match.ball.y, match.ballVelocity.x, match.ballVelocity.y };
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < sizeof(values); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 把模拟事件转发给遥测
+struct TelemetryHooks {
+    MatchTelemetry& telemetry;
+
+    void onWallBounce() { telemetry.wallBounce(); }
+    void onPaddleHit(int player, float hitRatio, pong::Vec2<float> velocity) { telemetry.paddleHit(player, hitRatio, velocity.x, velocity.y); }
+    void onAiDecision(float distance) { telemetry.aiDecision(distance); }
+    void onScore(int player, pong::Vec2<float>) { telemetry.score(player); }
+};
+
+template <pong::PlayerMode Mode, typename Num, typename Hooks>
+MatchResult runMatch(std::uint32_t seed, Hooks& hooks, MatchTelemetry* telemetry) {
+    const Num tick = Num(TICK);
+    pong::BasicMatchState<Num> match;
+    match.rngState = seed;
+    pong::serveBall(match);
+
+    MatchResult result;
+    while (result.ticks < MAX_TICKS_PER_MATCH) {
+        pong::PaddleInput player1 = pong::autoPilotInput(match, 1);
+        pong::PaddleInput player2;
+        if constexpr (Mode == pong::PlayerMode::TwoPlayers) {
+            player2 = pong::autoPilotInput(match, 2);
+        }
+
+        if (telemetry) {
+            telemetry->advanceTick();
+        }
+        int scorer = pong::stepPlaying<Mode>(match, player1, player2, tick, hooks);
+        ++result.ticks;
+
+        if (scorer != 0) {
+            if (match.player1Score >= pong::ClassicRules::winningScore ||
+                match.player2Score >= pong::ClassicRules::winningScore) {
+                break;
+            }
+            pong::serveBall(match);
+        }
+    }
+    result.player1Score = match.player1Score;
+    result.player2Score = match.player2Score;
+    result.checksum = stateChecksum(match);
+    return result;
+}
+
+template <pong::PlayerMode Mode, typename Num>
+MatchResult runMatch(std::uint32_t seed, MatchTelemetry* telemetry) {
+    pong::NullHooks nullHooks;
+    if (telemetry) {
+        TelemetryHooks hooks{ *telemetry };
+        return runMatch<Mode, Num>(seed, hooks, telemetry);
+    }
+    return runMatch<Mode, Num>(seed, nullHooks, telemetry);
+}
+
+template <typename Num>
+MatchResult runMatch(bool twoPlayers, std::uint32_t seed, MatchTelemetry* telemetry) {
+    return twoPlayers ? runMatch<pong::PlayerMode::TwoPlayers, Num>(seed, telemetry)
+                      : runMatch<pong::PlayerMode::OnePlayer, Num>(seed, telemetry);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int matches = 1000;
+    bool twoPlayers = false;
+    bool fixedPhysics = false;
+    const char* telemetryPath = nullptr;
+    bool allocCheck = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--two-players") == 0) {
+            twoPlayers = true;
+        }
+        else if (std::strcmp(argv[i], "--fixed") == 0) {
+            fixedPhysics = true;
+        }
+        else if (std::strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--alloc-check") == 0) {
+            allocCheck = true;
+        }
+        else {
+            matches = std::atoi(argv[i]);
+        }
+    }
+
+    if (allocCheck && !alloc_tracker::enabled) {
+        std::fprintf(stderr, "--alloc-check 需要以 PONG_ALLOC_TRACKING 编译\n");
+        return 1;
+    }
+
+    TelemetryStream telemetryStream;
+    std::unique_ptr<TelemetryRecorder> telemetryRecorder;
+    std::unique_ptr<MatchTelemetry> telemetry;
+    if (telemetryPath) {
+        if (!telemetryStream.open(telemetryPath)) {
+            std::fprintf(stderr, "遥测文件打开失败: %s\n", telemetryPath);
+            return 1;
+        }
+        telemetryRecorder = std::make_unique<TelemetryRecorder>(telemetryStream, 8);
+        telemetry = std::make_unique<MatchTelemetry>(*telemetryRecorder);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long long totalTicks = 0;
+    int player1Wins = 0;
+    std::uint64_t checksum = 0;
+    std::uint64_t warmAllocations = 0;
+    for (int i = 0; i < matches; ++i) {
+        if (i == 1) {
+            warmAllocations = alloc_tracker::allocationCount();
+        }
+        std::uint32_t seed = static_cast<std::uint32_t>(i + 1);
+        MatchResult result = fixedPhysics ? runMatch<pong::Fixed>(twoPlayers, seed, telemetry.get())
+                                          : runMatch<float>(twoPlayers, seed, telemetry.get());
+        totalTicks += result.ticks;
+        checksum = checksum * 31 + result.checksum;
+        if (result.player1Score > result.player2Score) {
+            ++player1Wins;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (telemetryRecorder) {
+        telemetryRecorder->flush();
+        telemetryStream.close();
+        std::printf("遥测: 丢弃 %llu 条事件\n", static_cast<unsigned long long>(telemetryRecorder->droppedEvents()));
+    }
+
+    std::printf("对局: %d (%s, %s)\n", matches, twoPlayers ? "双玩家" : "单玩家", fixedPhysics ? "定点物理" : "浮点物理");
+    std::printf("玩家1胜场: %d\n", player1Wins);
+    std::printf("状态校验: %016llx\n", static_cast<unsigned long long>(checksum));
+    std::printf("总步数: %lld, 耗时: %.3f 秒, %.0f 步/秒\n", totalTicks, seconds, totalTicks / seconds);
+
+    if (allocCheck && matches > 1) {
+        std::uint64_t steadyAllocations = alloc_tracker::allocationCount() - warmAllocations;
+        std::printf("热身后堆分配: %llu 次\n", static_cast<unsigned long long>(steadyAllocations));
+        if (steadyAllocations != 0) {
+            std::fprintf(stderr, "分配检查失败: 稳态对局中发生了堆分配\n");
+            return 1;
+        }
+    }
+    return 0;
+}
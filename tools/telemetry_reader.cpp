@@ -0,0 +1,132 @@
+﻿// 遥测文件读取工具
+// 用法: telemetry_reader <文件> [--csv]
+//   默认输出统计摘要：回合长度、击球速度、hitRatio分布、AI反应误差，以及各列压缩前后的大小
+//   --csv 逐条输出事件
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../telemetry.h"
+
+namespace {
+
+const char* eventName(TelemetryEvent kind) {
+    switch (kind) {
+    case TelemetryEvent::PaddleHit: return "paddle_hit";
+    case TelemetryEvent::Score: return "score";
+    case TelemetryEvent::AiDecision: return "ai_decision";
+    case TelemetryEvent::WallBounce: return "wall_bounce";
+    }
+    return "unknown";
+}
+
+struct Summary {
+    std::size_t count = 0;
+    double sum = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+
+    void add(double value) {
+        if (count == 0 || value < minimum) minimum = value;
+        if (count == 0 || value > maximum) maximum = value;
+        sum += value;
+        ++count;
+    }
+    void print(const char* name) const {
+        if (count == 0) {
+            std::printf("%-18s 无数据\n", name);
+            return;
+        }
+        std::printf("%-18s 次数 %-8zu 平均 %-10.2f 最小 %-10.2f 最大 %.2f\n", name, count, sum / count, minimum, maximum);
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "用法: %s <遥测文件> [--csv]\n", argv[0]);
+        return 1;
+    }
+    bool csv = argc > 2 && std::strcmp(argv[2], "--csv") == 0;
+
+    std::vector<TelemetryRecord> records;
+    TelemetryColumnSizes columnSizes;
+    TelemetryReadResult result = readTelemetryFile(argv[1], records, &columnSizes);
+    if (result == TelemetryReadResult::UnsupportedVersion) {
+        std::fprintf(stderr, "遥测文件版本不受支持（本工具读取版本 %u~%u）: %s\n",
+            TELEMETRY_MIN_VERSION, TELEMETRY_VERSION, argv[1]);
+        return 1;
+    }
+    if (result != TelemetryReadResult::Ok) {
+        std::fprintf(stderr, "遥测文件读取失败: %s\n", argv[1]);
+        return 1;
+    }
+
+    if (csv) {
+        std::printf("tick,event,player,count,value0,value1\n");
+        for (const TelemetryRecord& record : records) {
+            std::printf("%llu,%s,%d,%u,%g,%g\n", static_cast<unsigned long long>(record.tick), eventName(record.kind),
+                record.player, record.count, record.value0, record.value1);
+        }
+        return 0;
+    }
+
+    Summary rallyLength, hitSpeed, aiError;
+    const int HIT_BINS = 10;
+    std::size_t hitRatioBins[HIT_BINS] = {};
+    std::size_t hits[3] = {};
+    std::size_t points[3] = {};
+    std::size_t wallBounces = 0;
+
+    for (const TelemetryRecord& record : records) {
+        int player = std::clamp(record.player, 0, 2);
+        switch (record.kind) {
+        case TelemetryEvent::PaddleHit: {
+            hitSpeed.add(record.value0);
+            int bin = std::clamp(static_cast<int>(record.value1 * HIT_BINS), 0, HIT_BINS - 1);
+            ++hitRatioBins[bin];
+            ++hits[player];
+            break;
+        }
+        case TelemetryEvent::Score:
+            rallyLength.add(record.count);
+            ++points[player];
+            break;
+        case TelemetryEvent::AiDecision:
+            aiError.add(std::abs(record.value0));
+            break;
+        case TelemetryEvent::WallBounce:
+            ++wallBounces;
+            break;
+        }
+    }
+
+    std::printf("事件总数: %zu\n", records.size());
+    std::printf("得分: 玩家1 %zu, 玩家2 %zu;  击球: 玩家1 %zu, 玩家2 %zu;  撞墙 %zu\n",
+        points[1], points[2], hits[1], hits[2], wallBounces);
+    rallyLength.print("回合击球数");
+    hitSpeed.print("击球时球速");
+    aiError.print("AI反应误差(px)");
+
+    std::printf("hitRatio 分布（0=球拍上沿, 1=下沿）:\n");
+    std::size_t totalHits = std::max<std::size_t>(1, hits[1] + hits[2]);
+    for (int i = 0; i < HIT_BINS; ++i) {
+        double share = 100.0 * hitRatioBins[i] / totalHits;
+        std::printf("  %.1f-%.1f %6.2f%% %s\n", i / double(HIT_BINS), (i + 1) / double(HIT_BINS), share,
+            std::string(static_cast<std::size_t>(share / 2), '#').c_str());
+    }
+
+    // 压缩率（编码后比未压缩还大的列说明编码方式不适合这列数据）
+    const char* const COLUMN_NAMES[COLUMN_COUNT] = { "tick", "kind", "player", "count", "value0", "value1" };
+    std::printf("列大小（编码后 / 未压缩）:\n");
+    for (int column = 0; column < COLUMN_COUNT; ++column) {
+        std::uint64_t encoded = columnSizes.encoded[column];
+        std::uint64_t raw = columnSizes.raw[column];
+        std::printf("  %-7s %10llu / %-10llu %6.1f%%\n", COLUMN_NAMES[column], static_cast<unsigned long long>(encoded),
+            static_cast<unsigned long long>(raw), raw ? 100.0 * encoded / raw : 0.0);
+    }
+    return 0;
+}